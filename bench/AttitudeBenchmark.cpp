@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+
+#include <vector>
+
+#include "AttitudeHistory.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr uint64_t kIterations{1'000'000};
+constexpr size_t   kFrames{100};
+constexpr auto     kSamplePeriod = std::chrono::milliseconds(10);
+constexpr auto     kFramePeriod  = std::chrono::microseconds(33'333);
+
+/**
+ * Full history of a gimbal panning at constant rates, sampled at 100 Hz
+ */
+void fill(AttitudeHistory& history, AttitudeHistory::Clock::time_point start) {
+    for (size_t i = 0; i < AttitudeHistory::kCapacity; ++i) {
+        GimbalAttitudeMessage message;
+        message.yaw           = static_cast<int16_t>(-1200 + static_cast<int>(i) * 3);
+        message.pitch         = static_cast<int16_t>(100 - static_cast<int>(i));
+        message.yawVelocity   = 300;
+        message.pitchVelocity = -100;
+        history.add(start + i * kSamplePeriod, message);
+    }
+}
+} // namespace
+
+void runAttitudeBenchmarks() {
+    AttitudeHistory history;
+    const auto      start  = AttitudeHistory::Clock::time_point(std::chrono::seconds(1));
+    const auto      latest = start + (AttitudeHistory::kCapacity - 1) * kSamplePeriod;
+    fill(history, start);
+
+    const auto between = latest - std::chrono::milliseconds(1234) + std::chrono::microseconds(2500);
+    run("AttitudeHistory::poseAt interpolated", kIterations, [&] { doNotOptimize(history.poseAt(between)); });
+
+    const auto ahead = latest + std::chrono::milliseconds(20);
+    run("AttitudeHistory::poseAt extrapolated", kIterations, [&] { doNotOptimize(history.poseAt(ahead)); });
+
+    // Video frames at 30 Hz over the last 3.3 s of the history
+    std::vector<AttitudeHistory::Clock::time_point> times(kFrames);
+    for (size_t i = 0; i < times.size(); ++i) {
+        times[i] = latest - std::chrono::milliseconds(3300) + i * kFramePeriod;
+    }
+    std::vector<GimbalPose> poses(times.size());
+    run("AttitudeHistory::posesAt 100 ascending", kIterations / 100, [&] {
+        history.posesAt(times.data(), times.size(), poses.data());
+        doNotOptimize(poses);
+    });
+}
+
+} // namespace siyi::bench
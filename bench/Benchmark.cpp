@@ -0,0 +1,290 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+
+#include <QCoreApplication>
+
+namespace {
+std::atomic<uint64_t> allocations{0};
+
+std::string                      nameFilter;
+std::vector<siyi::bench::Record> records;
+} // namespace
+
+// Count every heap allocation of the process
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace siyi::bench {
+
+namespace {
+std::string escape(const std::string& text) {
+    std::string escaped;
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+/**
+ * Write records as JSON, one benchmark object per line
+ */
+bool writeJson(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "{\n  \"version\": \"" <<
+#ifdef VERSION
+        VERSION
+#else
+        "unknown"
+#endif
+        << "\",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < records.size(); ++i) {
+        out << "    {\"name\": \"" << escape(records[i].name) << "\"";
+        for (const auto& [metric, value] : records[i].metrics) {
+            out << ", \"" << metric << "\": " << value;
+        }
+        out << (i + 1 < records.size() ? "},\n" : "}\n");
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+/**
+ * Read a report written by writeJson
+ * @return Metrics by benchmark name
+ */
+std::map<std::string, std::map<std::string, double>> readJson(const std::string& path) {
+    std::map<std::string, std::map<std::string, double>> baseline;
+    std::ifstream                                         in(path);
+    std::string                                           line;
+    while (std::getline(in, line)) {
+        const auto nameStart = line.find("{\"name\": \"");
+        if (nameStart == std::string::npos) {
+            continue;
+        }
+        // Names are unescaped up to the closing quote
+        std::string name;
+        size_t      position = nameStart + std::strlen("{\"name\": \"");
+        for (; position < line.size() && line[position] != '"'; ++position) {
+            if (line[position] == '\\' && position + 1 < line.size()) {
+                ++position;
+            }
+            name += line[position];
+        }
+        auto& metrics = baseline[name];
+        while ((position = line.find(", \"", position)) != std::string::npos) {
+            const auto keyEnd = line.find('"', position + 3);
+            if (keyEnd == std::string::npos) {
+                break;
+            }
+            const auto key = line.substr(position + 3, keyEnd - position - 3);
+            metrics[key]   = std::strtod(line.c_str() + keyEnd + 3, nullptr);
+            position       = keyEnd;
+        }
+    }
+    return baseline;
+}
+
+/**
+ * Compare records with a baseline report. Baseline entries the run did not produce count as regressions
+ * unless --filter skipped them.
+ * @param tolerance Allowed relative slowdown, e.g. 0.1 for 10 %
+ * @return Number of regressions
+ */
+int compareWithBaseline(const std::string& path, double tolerance) {
+    const auto baseline = readJson(path);
+    if (baseline.empty()) {
+        std::fprintf(stderr, "Cannot read baseline %s\n", path.c_str());
+        return 1;
+    }
+
+    int regressions = 0;
+    if (nameFilter.empty()) {
+        for (const auto& [name, metrics] : baseline) {
+            const auto found =
+                std::any_of(records.begin(), records.end(), [&name = name](const Record& current) { return current.name == name; });
+            if (!found) {
+                std::printf("REGRESSION %s: missing from this run\n", name.c_str());
+                ++regressions;
+            }
+        }
+    }
+    for (const auto& current : records) {
+        const auto entry = baseline.find(current.name);
+        if (entry == baseline.end()) {
+            continue;
+        }
+        for (const auto& [metric, value] : current.metrics) {
+            const auto reference = entry->second.find(metric);
+            // Tail latencies are too noisy to gate on
+            if (reference == entry->second.end() || metric == "max_us" || metric == "p999_us") {
+                continue;
+            }
+            // Allocation counts of zero still allow a few warm-up allocations
+            const bool   higherIsBetter = metric.size() > 11 && metric.compare(metric.size() - 11, 11, "_per_second") == 0;
+            const double slack          = metric == "allocs_per_op" ? 0.01 : 0.0;
+            const bool   regressed      = higherIsBetter ? value < reference->second * (1.0 - tolerance)
+                                                         : value > reference->second * (1.0 + tolerance) + slack;
+            if (regressed) {
+                std::printf("REGRESSION %s %s: %.2f -> %.2f\n", current.name.c_str(), metric.c_str(), reference->second, value);
+                ++regressions;
+            }
+        }
+    }
+    std::printf("%d regression(s) against %s, tolerance %.0f %%\n", regressions, path.c_str(), tolerance * 100.0);
+    return regressions;
+}
+} // namespace
+
+uint64_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+bool enabled(const std::string& name) {
+    return nameFilter.empty() || name.find(nameFilter) != std::string::npos;
+}
+
+void record(Record record) {
+    records.push_back(std::move(record));
+}
+
+void report(const Result& result) {
+    std::printf("%-56s %12.1f ns/op %8.2f allocs/op %12llu iterations",
+                result.name.c_str(),
+                result.nsPerOp,
+                result.allocationsPerOp,
+                static_cast<unsigned long long>(result.iterations));
+    if (result.bytesPerOp > 0 && result.nsPerOp > 0.0) {
+        // bytes per ns equals GB/s, report MB/s
+        std::printf(" %10.1f MB/s", static_cast<double>(result.bytesPerOp) / result.nsPerOp * 1000.0);
+    }
+    std::printf("\n");
+
+    Record entry{result.name, {{"ns_per_op", result.nsPerOp}, {"allocs_per_op", result.allocationsPerOp}}};
+    if (result.bytesPerOp > 0 && result.nsPerOp > 0.0) {
+        entry.metrics.emplace_back("mb_per_second", static_cast<double>(result.bytesPerOp) / result.nsPerOp * 1000.0);
+    }
+    record(std::move(entry));
+}
+
+void reportLatency(const std::string& name, std::vector<std::chrono::nanoseconds>& samples, double allocationsPerOp) {
+    if (samples.empty()) {
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double fraction) {
+        const auto index = std::min(samples.size() - 1, static_cast<size_t>(fraction * static_cast<double>(samples.size())));
+        return static_cast<double>(samples[index].count()) / 1000.0;
+    };
+    std::printf("%-56s p50 %8.1f us  p99 %8.1f us  p99.9 %8.1f us  max %8.1f us %8.2f allocs/op\n",
+                name.c_str(),
+                percentile(0.5),
+                percentile(0.99),
+                percentile(0.999),
+                static_cast<double>(samples.back().count()) / 1000.0,
+                allocationsPerOp);
+
+    record({name,
+            {{"p50_us", percentile(0.5)},
+             {"p99_us", percentile(0.99)},
+             {"p999_us", percentile(0.999)},
+             {"max_us", static_cast<double>(samples.back().count()) / 1000.0},
+             {"allocs_per_op", allocationsPerOp}}});
+}
+
+void reportRate(const std::string& name, double perSecond, const char* unit) {
+    std::printf("%-56s %12.0f %s/s\n", name.c_str(), perSecond, unit);
+    record({name, {{std::string(unit) + "_per_second", perSecond}}});
+}
+
+} // namespace siyi::bench
+
+int main(int argc, char* argv[]) {
+    // Cameras need an application for their timers and communication thread
+    QCoreApplication app(argc, argv);
+
+    std::string jsonPath;
+    std::string baselinePath;
+    double      tolerance = 0.1;
+    const auto usage = [program = argv[0]] {
+        std::fprintf(stderr, "Usage: %s [--filter <text>] [--json <report>] [--baseline <report>] [--tolerance <fraction>]\n", program);
+        return 2;
+    };
+    for (int i = 1; i < argc; i += 2) {
+        const std::string option = argv[i];
+        if (i + 1 == argc) {
+            return usage();
+        }
+        if (option == "--filter") {
+            nameFilter = argv[i + 1];
+        } else if (option == "--json") {
+            jsonPath = argv[i + 1];
+        } else if (option == "--baseline") {
+            baselinePath = argv[i + 1];
+        } else if (option == "--tolerance") {
+            tolerance = std::atof(argv[i + 1]);
+        } else {
+            return usage();
+        }
+    }
+
+    siyi::bench::runEncodeBenchmarks();
+    siyi::bench::runCrcBenchmarks();
+    siyi::bench::runFramerBenchmarks();
+    siyi::bench::runParserBenchmarks();
+    siyi::bench::runAttitudeBenchmarks();
+    siyi::bench::runSchedulerBenchmarks();
+    siyi::bench::runRequestBenchmarks();
+    siyi::bench::runRealtimeBenchmarks();
+    siyi::bench::runLoopbackBenchmarks();
+    siyi::bench::runReplayBenchmarks();
+
+    if (!jsonPath.empty() && !siyi::bench::writeJson(jsonPath)) {
+        std::fprintf(stderr, "Cannot write %s\n", jsonPath.c_str());
+        return 2;
+    }
+    // Non-zero exit status lets CI gate an SDK upgrade on the baseline
+    if (!baselinePath.empty() && siyi::bench::compareWithBaseline(baselinePath, tolerance) > 0) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace siyi::bench {
+
+/**
+ * Result of one benchmark run
+ */
+struct Result {
+    std::string name;
+    uint64_t    iterations{0};
+    double      nsPerOp{0.0};
+    double      allocationsPerOp{0.0};
+    uint64_t    bytesPerOp{0}; // Processed bytes per call, used to report throughput
+};
+
+/**
+ * Named values of one benchmark, written to the JSON report
+ */
+struct Record {
+    std::string                                 name;
+    std::vector<std::pair<std::string, double>> metrics;
+};
+
+/**
+ * @brief Number of heap allocations made by the process so far
+ */
+uint64_t allocationCount();
+
+/**
+ * @brief Check benchmark name against the --filter option
+ * @param name Benchmark name
+ * @return True if the benchmark should run
+ */
+bool enabled(const std::string& name);
+
+/**
+ * @brief Add benchmark values to the machine-readable report
+ * @param record Benchmark name and values, metric names ending in "_per_second" are better when higher
+ */
+void record(Record record);
+
+/**
+ * @brief Print benchmark result
+ * @param result Result to print
+ */
+void report(const Result& result);
+
+/**
+ * @brief Print latency distribution
+ * @param name Benchmark name
+ * @param samples Measured latencies, sorted in place
+ * @param allocationsPerOp Heap allocations per measured call
+ */
+void reportLatency(const std::string& name, std::vector<std::chrono::nanoseconds>& samples, double allocationsPerOp);
+
+/**
+ * @brief Print sustained rate
+ * @param name Benchmark name
+ * @param perSecond Operations per second
+ * @param unit Operation unit, e.g. "frames"
+ */
+void reportRate(const std::string& name, double perSecond, const char* unit);
+
+/**
+ * @brief Keep the compiler from optimizing away a computed value
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief Run function and measure time and heap allocations per call
+ * @param name Benchmark name
+ * @param iterations Number of measured calls
+ * @param function Function to benchmark
+ * @param bytesPerOp Bytes processed per call, 0 if throughput is meaningless
+ * @return Benchmark result
+ */
+template<typename Function>
+Result run(const std::string& name, uint64_t iterations, Function&& function, uint64_t bytesPerOp = 0) {
+    if (!enabled(name)) {
+        return {};
+    }
+
+    // Warm up caches and lazily initialized state
+    for (uint64_t i = 0; i < iterations / 10 + 1; ++i) {
+        function();
+    }
+
+    const auto allocationsBefore = allocationCount();
+    const auto start             = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        function();
+    }
+    const auto elapsed     = std::chrono::steady_clock::now() - start;
+    const auto allocations = allocationCount() - allocationsBefore;
+
+    Result result;
+    result.name             = name;
+    result.iterations       = iterations;
+    result.nsPerOp          = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / iterations;
+    result.allocationsPerOp = static_cast<double>(allocations) / iterations;
+    result.bytesPerOp       = bytesPerOp;
+    report(result);
+    return result;
+}
+
+// Benchmark suites
+void runEncodeBenchmarks();
+void runCrcBenchmarks();
+void runFramerBenchmarks();
+void runParserBenchmarks();
+void runRealtimeBenchmarks();
+void runLoopbackBenchmarks();
+void runReplayBenchmarks();
+void runAttitudeBenchmarks();
+void runSchedulerBenchmarks();
+void runRequestBenchmarks();
+
+} // namespace siyi::bench
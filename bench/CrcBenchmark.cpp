@@ -0,0 +1,79 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Crc.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr size_t kCaptureSize{1 << 20}; // Size of a simulated telemetry capture
+
+/**
+ * @brief Check that every kernel and incremental use matches the bytewise reference
+ * @return True if all results are bit-exact
+ */
+bool verifyKernels(const std::vector<uint8_t>& data) {
+    for (size_t length = 0; length <= 256; ++length) {
+        for (uint16_t init : {uint16_t{0}, uint16_t{0xFFFF}, uint16_t{0x1D0F}}) {
+            const auto expected = Crc::calculateCRC16(data.data(), length, init, Crc::Kernel::Bytewise);
+            if (Crc::calculateCRC16(data.data(), length, init, Crc::Kernel::Slicing4) != expected
+                || Crc::calculateCRC16(data.data(), length, init, Crc::Kernel::Slicing8) != expected
+                || Crc::calculateCRC16(data.data(), length, init) != expected) {
+                std::fprintf(stderr, "CRC kernel mismatch at length %zu\n", length);
+                return false;
+            }
+
+            // Resume from every possible prefix
+            for (size_t split = 0; split <= length; ++split) {
+                Crc16 crc(init);
+                crc.update(data.data(), split).update(data.data() + split, length - split);
+                if (crc.value() != expected) {
+                    std::fprintf(stderr, "Incremental CRC mismatch at length %zu split %zu\n", length, split);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
+void runCrcBenchmarks() {
+    std::vector<uint8_t> data(kCaptureSize);
+    std::mt19937         random(42);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(random());
+    }
+
+    if (!verifyKernels(data)) {
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Typical frame sizes
+    for (size_t length : {size_t{10}, size_t{18}, size_t{64}}) {
+        for (auto [kernel, name] : {std::pair{Crc::Kernel::Bytewise, "bytewise"},
+                                    std::pair{Crc::Kernel::Slicing4, "slicing4"},
+                                    std::pair{Crc::Kernel::Slicing8, "slicing8"}}) {
+            run("Crc::calculateCRC16 " + std::string(name) + " " + std::to_string(length) + " bytes",
+                10'000'000,
+                [&, kernel = kernel] { doNotOptimize(Crc::calculateCRC16(data.data(), length, 0, kernel)); },
+                length);
+        }
+    }
+
+    // Capture replay
+    for (auto [kernel, name] : {std::pair{Crc::Kernel::Bytewise, "bytewise"},
+                                std::pair{Crc::Kernel::Slicing4, "slicing4"},
+                                std::pair{Crc::Kernel::Slicing8, "slicing8"}}) {
+        run("Crc::calculateCRC16 " + std::string(name) + " 1 MiB",
+            200,
+            [&, kernel = kernel] { doNotOptimize(Crc::calculateCRC16(data.data(), data.size(), 0, kernel)); },
+            data.size());
+    }
+}
+
+} // namespace siyi::bench
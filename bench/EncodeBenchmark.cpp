@@ -0,0 +1,189 @@
+#include "Benchmark.h"
+
+#include <utility>
+
+#include "MessageBuilder.h"
+#include "SiyiCore.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr uint64_t kIterations{1'000'000};
+constexpr uint64_t kBuilderIterations{200'000};
+
+// The protocol core encodes, decodes and parses at compile time
+constexpr bool coreRoundTrip() {
+    Encoder<>   encoder;
+    FrameBuffer frame;
+    encoder.buildDataStreamRequestMessage(frame, DataStreamType::Attitude, DataStreamFrequency::Hz10);
+    const auto view = decodeFrame(frame.data(), frame.size());
+
+    DataStreamMessage message;
+    return view.valid() && parseMessage(view, message) && message.dataType == static_cast<uint8_t>(DataStreamType::Attitude);
+}
+
+static_assert(coreRoundTrip(), "Protocol core must be usable in constant expressions");
+
+// Templates patch the sequence number and CRC, the bytes must not differ from a full encode
+constexpr bool templateMatchesEncode(const FrameTemplate& frameTemplate, const uint8_t* data, size_t dataLength) {
+    for (const uint16_t sequenceNumber : {0x0000, 0x0001, 0x00FF, 0x1234, 0xFF00, 0xFFFF}) {
+        FrameBuffer patched;
+        FrameBuffer encoded;
+        frameTemplate.encode(patched, sequenceNumber);
+        encodeFrame(encoded, sequenceNumber, frameTemplate.command(), data, dataLength);
+        if (patched.length != encoded.length) {
+            return false;
+        }
+        for (size_t i = 0; i < encoded.length; ++i) {
+            if (patched.bytes[i] != encoded.bytes[i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+constexpr bool templatesMatchEncode() {
+    const uint8_t values[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    return templateMatchesEncode(templates::kFirmwareRequest, nullptr, 0) &&
+           templateMatchesEncode(templates::kHardwareIDRequest, nullptr, 0) &&
+           templateMatchesEncode(templates::kAutoFocusRequest, &values[1], 1) &&
+           templateMatchesEncode(templates::kGimbalCenterRequest, &values[1], 1) &&
+           templateMatchesEncode(templates::kAcquireGimbalAttitudeRequest, nullptr, 0) &&
+           templateMatchesEncode(templates::kAcquireGimbalInfoRequest, nullptr, 0) &&
+           templateMatchesEncode(templates::kTakePhotoRequest, &values[0], 1) &&
+           templateMatchesEncode(templates::kSwitchHDRRequest, &values[1], 1) &&
+           templateMatchesEncode(templates::kStartStopRecordingRequest, &values[2], 1) &&
+           templateMatchesEncode(templates::kMotionLockModeRequest, &values[3], 1) &&
+           templateMatchesEncode(templates::kMotionFollowModeRequest, &values[4], 1) &&
+           templateMatchesEncode(templates::kMotionFPVModeRequest, &values[5], 1) &&
+           templateMatchesEncode(templates::kSetVideoOutputHDMIRequest, &values[6], 1) &&
+           templateMatchesEncode(templates::kSetVideoOutputCVBSRequest, &values[7], 1);
+}
+
+static_assert(templatesMatchEncode(), "Frame templates must encode the same bytes as encodeFrame");
+} // namespace
+
+void runEncodeBenchmarks() {
+    MessageBuilder builder;
+    FrameBuffer    frame;
+
+    // Every request builder, heap based and allocation-free
+    using Builder = std::pair<QByteArray (*)(MessageBuilder&), void (*)(MessageBuilder&, FrameBuffer&)>;
+    const std::pair<const char*, Builder> builders[] = {
+        {"buildFirmwareRequestMessage",
+         {[](MessageBuilder& b) { return b.buildFirmwareRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildFirmwareRequestMessage(f); }}},
+        {"buildHardwareIDRequestMessage",
+         {[](MessageBuilder& b) { return b.buildHardwareIDRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildHardwareIDRequestMessage(f); }}},
+        {"buildManualZoomRequestMessage",
+         {[](MessageBuilder& b) { return b.buildManualZoomRequestMessage(1); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildManualZoomRequestMessage(f, 1); }}},
+        {"buildAbsoluteZoomRequestMessage",
+         {[](MessageBuilder& b) { return b.buildAbsoluteZoomRequestMessage(5); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildAbsoluteZoomRequestMessage(f, 5); }}},
+        {"buildAutoFocusRequestMessage",
+         {[](MessageBuilder& b) { return b.buildAutoFocusRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildAutoFocusRequestMessage(f); }}},
+        {"buildManualFocusShotRequestMessage",
+         {[](MessageBuilder& b) { return b.buildManualFocusShotRequestMessage(-1); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildManualFocusShotRequestMessage(f, -1); }}},
+        {"buildGimbalRotationRequestMessage",
+         {[](MessageBuilder& b) { return b.buildGimbalRotationRequestMessage(10, -10); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildGimbalRotationRequestMessage(f, 10, -10); }}},
+        {"buildGimbalCenterRequestMessage",
+         {[](MessageBuilder& b) { return b.buildGimbalCenterRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildGimbalCenterRequestMessage(f); }}},
+        {"buildSetGimbalControlAngleRequestMessage",
+         {[](MessageBuilder& b) { return b.buildSetGimbalControlAngleRequestMessage(450, -900); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildSetGimbalControlAngleRequestMessage(f, 450, -900); }}},
+        {"buildAcquireGimbalAttitudeRequestMessage",
+         {[](MessageBuilder& b) { return b.buildAcquireGimbalAttitudeRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildAcquireGimbalAttitudeRequestMessage(f); }}},
+        {"buildTakePhotoRequestMessage",
+         {[](MessageBuilder& b) { return b.buildTakePhotoRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildTakePhotoRequestMessage(f); }}},
+        {"buildSwitchHDRRequestMessage",
+         {[](MessageBuilder& b) { return b.buildSwitchHDRRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildSwitchHDRRequestMessage(f); }}},
+        {"buildStartStopRecordingRequestMessage",
+         {[](MessageBuilder& b) { return b.buildStartStopRecordingRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildStartStopRecordingRequestMessage(f); }}},
+        {"buildMotionLockModeRequestMessage",
+         {[](MessageBuilder& b) { return b.buildMotionLockModeRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildMotionLockModeRequestMessage(f); }}},
+        {"buildMotionFollowModeRequestMessage",
+         {[](MessageBuilder& b) { return b.buildMotionFollowModeRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildMotionFollowModeRequestMessage(f); }}},
+        {"buildMotionFPVModeRequestMessage",
+         {[](MessageBuilder& b) { return b.buildMotionFPVModeRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildMotionFPVModeRequestMessage(f); }}},
+        {"buildSetVideoOutputHDMIRequestMessage",
+         {[](MessageBuilder& b) { return b.buildSetVideoOutputHDMIRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildSetVideoOutputHDMIRequestMessage(f); }}},
+        {"buildSetVideoOutputCVBSRequestMessage",
+         {[](MessageBuilder& b) { return b.buildSetVideoOutputCVBSRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildSetVideoOutputCVBSRequestMessage(f); }}},
+        {"buildAcquireGimbalInfoRequestMessage",
+         {[](MessageBuilder& b) { return b.buildAcquireGimbalInfoRequestMessage(); },
+          [](MessageBuilder& b, FrameBuffer& f) { b.buildAcquireGimbalInfoRequestMessage(f); }}},
+        {"buildDataStreamRequestMessage",
+         {[](MessageBuilder& b) { return b.buildDataStreamRequestMessage(DataStreamType::Attitude, DataStreamFrequency::Hz50); },
+          [](MessageBuilder& b, FrameBuffer& f) {
+              b.buildDataStreamRequestMessage(f, DataStreamType::Attitude, DataStreamFrequency::Hz50);
+          }}},
+    };
+    for (const auto& [name, build] : builders) {
+        const auto toByteArray = build.first;
+        run(std::string("QByteArray ") + name, kBuilderIterations, [&] { doNotOptimize(toByteArray(builder)); });
+    }
+    for (const auto& [name, build] : builders) {
+        const auto toFrame = build.second;
+        run(std::string("FrameBuffer ") + name, kBuilderIterations, [&] {
+            toFrame(builder, frame);
+            doNotOptimize(frame);
+        });
+    }
+
+    // Generic encoder with the largest payload
+    const uint8_t payload[FrameBuffer::kMaxPayloadSize]{};
+    run("MessageBuilder::encode 32 byte payload", kIterations, [&] {
+        doNotOptimize(builder.encode(frame, Command::GIMBAL_CONTROL_ANGLE, payload, sizeof(payload)));
+        doNotOptimize(frame);
+    });
+
+    // Decoder, valid frame and CRC mismatch
+    builder.buildSetGimbalControlAngleRequestMessage(frame, 450, -900);
+    const QByteArray encoded = builder.buildSetGimbalControlAngleRequestMessage(450, -900);
+    run("MessageBuilder::decode", kIterations, [&] { doNotOptimize(MessageBuilder::decode(frame.data(), frame.size())); });
+    run("MessageBuilder::decode QByteArray", kIterations, [&] { doNotOptimize(MessageBuilder::decode(encoded)); });
+    FrameBuffer corrupt = frame;
+    corrupt.bytes[FrameBuffer::kHeaderSize] ^= 0x01;
+    run("MessageBuilder::decode CRC mismatch", kIterations, [&] { doNotOptimize(MessageBuilder::decode(corrupt.data(), corrupt.size())); });
+
+    // Protocol core without the Qt adapter
+    Encoder<> encoder;
+    run("Encoder buildSetGimbalControlAngleRequestMessage", kIterations, [&] {
+        encoder.buildSetGimbalControlAngleRequestMessage(frame, 450, -900);
+        doNotOptimize(frame);
+    });
+    // Attitude polling, full encode against the pre-encoded template
+    uint16_t sequenceNumber = 0;
+    run("encodeFrame ACQUIRE_GIMBAL_ATT", kIterations, [&] {
+        encodeFrame(frame, sequenceNumber++, Command::ACQUIRE_GIMBAL_ATT);
+        doNotOptimize(frame);
+    });
+    run("FrameTemplate::encode ACQUIRE_GIMBAL_ATT", kIterations, [&] {
+        templates::kAcquireGimbalAttitudeRequest.encode(frame, sequenceNumber++);
+        doNotOptimize(frame);
+    });
+
+    encoder.buildSetGimbalControlAngleRequestMessage(frame, 450, -900);
+    run("decodeFrame + dispatchMessage", kIterations, [&] {
+        const auto view = decodeFrame(frame.data(), frame.size());
+        dispatchMessage(view, [](const auto& message) { doNotOptimize(message); });
+    });
+}
+
+} // namespace siyi::bench
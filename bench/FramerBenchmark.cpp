@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "MessageBuilder.h"
+#include "StreamFramer.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr size_t kFrames{20'000};
+
+using Frames = std::vector<std::vector<uint8_t>>;
+
+/**
+ * Stream of frames with corrupted frames and noise in between, like a UART with line errors
+ * @param validFrames Set to the intact frames in stream order
+ */
+std::vector<uint8_t> makeStream(Frames& validFrames) {
+    MessageBuilder       builder;
+    FrameBuffer          frame;
+    std::vector<uint8_t> stream;
+    std::mt19937         random(42);
+    validFrames.clear();
+    for (size_t i = 0; i < kFrames; ++i) {
+        builder.buildSetGimbalControlAngleRequestMessage(frame, static_cast<int16_t>(i), -static_cast<int16_t>(i));
+        const auto offset = stream.size();
+        stream.insert(stream.end(), frame.data(), frame.data() + frame.size());
+        if (random() % 10 == 0) {
+            stream[offset + random() % frame.size()] ^= static_cast<uint8_t>(1 + random() % 255);
+        } else {
+            validFrames.emplace_back(frame.data(), frame.data() + frame.size());
+        }
+        // Noise, half of it looks like the first STX byte
+        for (auto noise = random() % 4; noise > 0; --noise) {
+            stream.push_back(noise % 2 == 0 ? 0x55 : static_cast<uint8_t>(random()));
+        }
+    }
+    return stream;
+}
+
+/**
+ * Feed stream in chunks of the given size
+ * @return Number of emitted frames
+ */
+size_t feed(StreamFramer& framer, const std::vector<uint8_t>& stream, size_t chunk) {
+    size_t frames = 0;
+    for (size_t position = 0; position < stream.size(); position += chunk) {
+        framer.feed(stream.data() + position, std::min(chunk, stream.size() - position), [&frames](const FrameView&) { ++frames; });
+    }
+    return frames;
+}
+
+/**
+ * Feed stream in chunks of the given size and keep a copy of every emitted frame
+ */
+Frames collect(const std::vector<uint8_t>& stream, size_t chunk) {
+    StreamFramer framer;
+    Frames       frames;
+    for (size_t position = 0; position < stream.size(); position += chunk) {
+        framer.feed(stream.data() + position, std::min(chunk, stream.size() - position),
+                    [&frames](const FrameView& frame) { frames.emplace_back(frame.frame, frame.frame + frame.frameSize); });
+    }
+    return frames;
+}
+} // namespace
+
+void runFramerBenchmarks() {
+    Frames     validFrames;
+    const auto stream = makeStream(validFrames);
+
+    // Every chunk boundary must yield exactly the intact frames, byte for byte and in order
+    const std::vector<size_t> chunks{1, 2, 3, 7, 64, 1500, 4096, stream.size()};
+    for (auto chunk : chunks) {
+        const auto frames = collect(stream, chunk);
+        if (frames != validFrames) {
+            const auto mismatch = std::mismatch(frames.begin(), frames.end(), validFrames.begin(), validFrames.end());
+            std::fprintf(stderr, "StreamFramer emitted %zu frames instead of %zu with %zu byte chunks, first difference at frame %zu\n",
+                         frames.size(), validFrames.size(), chunk, static_cast<size_t>(mismatch.first - frames.begin()));
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    for (auto chunk : {size_t{1}, size_t{64}, size_t{4096}}) {
+        StreamFramer framer;
+        run(
+            "StreamFramer::feed " + std::to_string(chunk) + " byte chunks", 20, [&] { doNotOptimize(feed(framer, stream, chunk)); },
+            stream.size());
+    }
+}
+
+} // namespace siyi::bench
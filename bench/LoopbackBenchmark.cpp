@@ -0,0 +1,263 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+#include <poll.h>
+
+#include "CameraEmulator.h"
+#include "CameraManager.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr size_t                    kLatencySamples{5'000};
+constexpr size_t                    kStartupSamples{200};
+constexpr size_t                    kDiscoverySamples{20};
+constexpr size_t                    kDiscoveryAddresses{254}; // 127.0.0.1 to 127.0.0.254
+constexpr std::chrono::milliseconds kDiscoveryTimeout{100};
+constexpr size_t                    kBurstFrames{100'000};
+constexpr int                       kWindow{64}; // Requests in flight while measuring the sustained rate
+constexpr std::chrono::seconds      kRateDuration{2};
+constexpr std::chrono::milliseconds kSettleTime{200};
+
+/**
+ * Emulated camera served by its own thread
+ */
+class EmulatorThread {
+public:
+    EmulatorThread() {
+        emulator::EmulatorConfig config;
+        config.port = 0;
+        _emulator   = std::make_unique<emulator::CameraEmulator>(config);
+        _emulator->open();
+        _thread = std::thread([this] { loop(); });
+    }
+
+    ~EmulatorThread() {
+        _stop.store(true);
+        _thread.join();
+    }
+
+    [[nodiscard]] uint16_t port() const { return _emulator->port(); }
+
+    /**
+     * @return Frames received by the emulator so far
+     */
+    [[nodiscard]] uint64_t framesReceived() const { return _framesReceived.load(std::memory_order_acquire); }
+
+private:
+    void loop() {
+        pollfd descriptor{_emulator->descriptor(), POLLIN, 0};
+        while (!_stop.load(std::memory_order_relaxed)) {
+            ::poll(&descriptor, 1, 10);
+            const auto now = emulator::CameraEmulator::Clock::now();
+            _emulator->receive(now);
+            _emulator->update(now);
+            _framesReceived.store(_emulator->stats().framesReceived, std::memory_order_release);
+        }
+    }
+
+private:
+    std::unique_ptr<emulator::CameraEmulator> _emulator;
+    std::thread                               _thread;
+    std::atomic<bool>                         _stop{false};
+    std::atomic<uint64_t>                     _framesReceived{0};
+};
+
+/**
+ * Wait until the emulator count stops changing
+ * @return Frames received by the emulator
+ */
+uint64_t settle(const EmulatorThread& emulator) {
+    auto received = emulator.framesReceived();
+    while (true) {
+        std::this_thread::sleep_for(kSettleTime);
+        const auto current = emulator.framesReceived();
+        if (current == received) {
+            return current;
+        }
+        received = current;
+    }
+}
+
+/**
+ * Scan of a /24, the emulator is bound to any address and answers on every loopback address
+ */
+void measureDiscovery(CameraManager& manager, quint16 port) {
+    const std::string name = "Loopback discover /24";
+    if (!enabled(name)) {
+        return;
+    }
+
+    auto options    = DiscoveryOptions::range("127.0.0.1", "127.0.0.254", port);
+    options.timeout = kDiscoveryTimeout;
+
+    std::vector<std::chrono::nanoseconds> scan;
+    std::vector<std::chrono::nanoseconds> roundTrip;
+    scan.reserve(kDiscoverySamples);
+    roundTrip.reserve(kDiscoverySamples * kDiscoveryAddresses);
+    size_t missing         = 0;
+    size_t missingFirmware = 0;
+    for (size_t i = 0; i < kDiscoverySamples; ++i) {
+        const auto start   = std::chrono::steady_clock::now();
+        const auto cameras = manager.discover(options).get();
+        scan.push_back(std::chrono::steady_clock::now() - start);
+        missing += kDiscoveryAddresses - std::min(cameras.size(), kDiscoveryAddresses);
+        for (const auto& camera : cameras) {
+            roundTrip.push_back(camera.roundTripTime);
+            missingFirmware += camera.firmware ? 0 : 1;
+        }
+    }
+    if (missing > 0 || missingFirmware > 0) {
+        std::printf("%s: %zu cameras and %zu firmware replies missed the timeout\n", name.c_str(), missing, missingFirmware);
+    }
+    reportLatency(name + " with " + std::to_string(kDiscoveryTimeout.count()) + " ms timeout", scan, 0.0);
+    reportLatency(name + " probe round trip", roundTrip, 0.0);
+}
+
+/**
+ * Time from adding a camera until its startup handshake completes
+ */
+void measureStartup(CameraManager& manager, quint16 port) {
+    const std::string name = "Loopback addCamera to ready";
+    if (!enabled(name)) {
+        return;
+    }
+
+    std::vector<std::chrono::nanoseconds> startup;
+    startup.reserve(kStartupSamples);
+    size_t failed = 0;
+    for (size_t i = 0; i < kStartupSamples; ++i) {
+        const auto start  = std::chrono::steady_clock::now();
+        auto*      camera = manager.addCamera("127.0.0.1", port);
+        if (camera->waitForReady(CameraApi::kDefaultReadyDeadline)) {
+            startup.push_back(std::chrono::steady_clock::now() - start);
+        } else {
+            ++failed;
+        }
+        manager.removeCamera(camera);
+    }
+    if (failed > 0) {
+        std::printf("%s: %zu of %zu handshakes timed out\n", name.c_str(), failed, kStartupSamples);
+    }
+    reportLatency(name, startup, 0.0);
+}
+
+/**
+ * Command-to-ACK latency, one request at a time
+ */
+void measureAckLatency(CameraApi& camera) {
+    const std::string name = "Loopback setGimbalCenterAsync";
+    if (!enabled(name)) {
+        return;
+    }
+
+    std::vector<std::chrono::nanoseconds> roundTrip;
+    std::vector<std::chrono::nanoseconds> callToResult;
+    roundTrip.reserve(kLatencySamples);
+    callToResult.reserve(kLatencySamples);
+
+    size_t     failed            = 0;
+    const auto allocationsBefore = allocationCount();
+    for (size_t i = 0; i < kLatencySamples; ++i) {
+        const auto start  = std::chrono::steady_clock::now();
+        const auto result = camera.setGimbalCenterAsync().get();
+        if (!result.ok()) {
+            ++failed;
+            continue;
+        }
+        callToResult.push_back(std::chrono::steady_clock::now() - start);
+        roundTrip.push_back(result.roundTripTime);
+    }
+    const auto allocations = static_cast<double>(allocationCount() - allocationsBefore) / kLatencySamples;
+    if (failed > 0) {
+        std::printf("%s: %zu of %zu requests failed\n", name.c_str(), failed, kLatencySamples);
+    }
+
+    // Round trip is measured by the communication thread from send to ACK, call to result adds thread hand-offs
+    reportLatency(name + " send to ACK", roundTrip, allocations);
+    reportLatency(name + " call to result", callToResult, allocations);
+}
+
+/**
+ * Sustained acknowledged requests with a fixed window in flight
+ */
+void measureRequestRate(CameraApi& camera) {
+    const std::string name = "Loopback zoomAsync windowed";
+    if (!enabled(name)) {
+        return;
+    }
+
+    std::atomic<int>      inFlight{0};
+    std::atomic<uint64_t> acknowledged{0};
+    const auto            start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < kRateDuration) {
+        if (inFlight.load(std::memory_order_acquire) >= kWindow) {
+            std::this_thread::yield();
+            continue;
+        }
+        inFlight.fetch_add(1, std::memory_order_relaxed);
+        camera.zoomAsync(1, [&](const RequestResult& result) {
+            if (result.ok()) {
+                acknowledged.fetch_add(1, std::memory_order_relaxed);
+            }
+            inFlight.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Callbacks reference the counters, wait for the last ones
+    while (inFlight.load(std::memory_order_acquire) > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    reportRate(name, static_cast<double>(acknowledged.load()) / elapsed, "requests");
+}
+
+/**
+ * Fire-and-forget frames through the signal path until the emulator has seen all of them
+ */
+void measureFrameRate(CameraApi& camera, const EmulatorThread& emulator) {
+    const std::string name = "Loopback takePhoto burst";
+    if (!enabled(name)) {
+        return;
+    }
+
+    const auto before = settle(emulator);
+    const auto start  = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kBurstFrames; ++i) {
+        doNotOptimize(camera.takePhoto());
+    }
+    const auto received = settle(emulator) - before;
+    // The final settle period did not carry traffic
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start - kSettleTime).count();
+
+    if (received < kBurstFrames) {
+        std::printf("%s: %llu of %zu frames lost\n", name.c_str(), static_cast<unsigned long long>(kBurstFrames - received), kBurstFrames);
+    }
+    reportRate(name, static_cast<double>(received) / elapsed, "frames");
+}
+} // namespace
+
+void runLoopbackBenchmarks() {
+    EmulatorThread emulator;
+    CameraManager  manager(0);
+    measureStartup(manager, emulator.port());
+    measureDiscovery(manager, emulator.port());
+
+    auto* camera = manager.addCamera("127.0.0.1", emulator.port());
+    if (!camera->waitForReady(CameraApi::kDefaultReadyDeadline)) {
+        std::printf("Loopback: emulator did not answer the startup requests\n");
+        return;
+    }
+    // The emulator has no gimbal MCU to protect, throughput is measured without the frame rate limit
+    camera->setMaxFrameRate(0);
+
+    measureAckLatency(*camera);
+    measureRequestRate(*camera);
+    measureFrameRate(*camera, emulator);
+}
+
+} // namespace siyi::bench
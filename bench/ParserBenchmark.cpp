@@ -0,0 +1,73 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Codec.h"
+#include "MessageParser.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr uint64_t kIterations{1'000'000};
+
+/**
+ * Subscriber that only touches the message
+ */
+class Sink : public MessageHandler {
+public:
+    void onFirmware(const FirmwareMessage& message) override { doNotOptimize(message); }
+    void onHardwareID(const HardwareIDMessage& message) override { doNotOptimize(message); }
+    void onAutoFocus(const AutoFocusMessage& message) override { doNotOptimize(message); }
+    void onManualZoom(const ManualZoomMessage& message) override { doNotOptimize(message); }
+    void onAbsoluteZoom(const AbsoluteZoomMessage& message) override { doNotOptimize(message); }
+    void onManualFocus(const ManualFocusMessage& message) override { doNotOptimize(message); }
+    void onGimbalRotation(const GimbalRotationMessage& message) override { doNotOptimize(message); }
+    void onGimbalCenter(const GimbalCenterMessage& message) override { doNotOptimize(message); }
+    void onFunctionFeedback(const FunctionFeedbackMessage& message) override { doNotOptimize(message); }
+    void onGimbalAttitude(const GimbalAttitudeMessage& message) override { doNotOptimize(message); }
+    void onGimbalControlAngle(const GimbalControlAngleMessage& message) override { doNotOptimize(message); }
+    void onCameraStatusInfo(const CameraStatusInfoMessage& message) override { doNotOptimize(message); }
+    void onDataStream(const DataStreamMessage& message) override { doNotOptimize(message); }
+};
+
+/**
+ * Parse a response frame of Message carrying payload
+ */
+template<typename Message>
+void benchmarkParse(const MessageParser& parser, const char* name, const char* payload) {
+    FrameBuffer frame;
+    encodeFrame(frame, 0, Message::kCommand, reinterpret_cast<const uint8_t*>(payload), std::strlen(payload));
+    const auto view        = decodeFrame(frame.data(), frame.size());
+    const auto receiveTime = std::chrono::steady_clock::now();
+    if (!parser.parse(view, receiveTime)) {
+        std::printf("%s: sample payload rejected\n", name);
+        std::exit(1);
+    }
+    run(std::string("MessageParser::parse ") + name, kIterations, [&] { doNotOptimize(parser.parse(view, receiveTime)); });
+}
+} // namespace
+
+void runParserBenchmarks() {
+    Sink          sink;
+    MessageParser parser;
+    parser.addHandler(&sink);
+
+    // Payloads are ASCII so the table stays readable, only their length and layout matter
+    benchmarkParse<FirmwareMessage>(parser, "FirmwareMessage", "0123456789ab");
+    benchmarkParse<HardwareIDMessage>(parser, "HardwareIDMessage", "6B0000000001");
+    benchmarkParse<AutoFocusMessage>(parser, "AutoFocusMessage", "1");
+    benchmarkParse<ManualZoomMessage>(parser, "ManualZoomMessage", "12");
+    benchmarkParse<AbsoluteZoomMessage>(parser, "AbsoluteZoomMessage", "1");
+    benchmarkParse<ManualFocusMessage>(parser, "ManualFocusMessage", "1");
+    benchmarkParse<GimbalRotationMessage>(parser, "GimbalRotationMessage", "1");
+    benchmarkParse<GimbalCenterMessage>(parser, "GimbalCenterMessage", "1");
+    benchmarkParse<FunctionFeedbackMessage>(parser, "FunctionFeedbackMessage", "0");
+    benchmarkParse<GimbalAttitudeMessage>(parser, "GimbalAttitudeMessage", "0123456789ab");
+    benchmarkParse<GimbalControlAngleMessage>(parser, "GimbalControlAngleMessage", "012345");
+    benchmarkParse<CameraStatusInfoMessage>(parser, "CameraStatusInfoMessage", "0101010");
+    benchmarkParse<DataStreamMessage>(parser, "DataStreamMessage", "1");
+}
+
+} // namespace siyi::bench
@@ -0,0 +1,108 @@
+#include "Benchmark.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "CameraManager.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr size_t kSamples{20'000};
+
+/**
+ * Loopback socket standing in for the camera
+ */
+class Receiver {
+public:
+    Receiver() {
+        _fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+
+        socklen_t length = sizeof(address);
+        ::getsockname(_fd, reinterpret_cast<sockaddr*>(&address), &length);
+        _port = ntohs(address.sin_port);
+
+        timeval timeout{1, 0};
+        ::setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    ~Receiver() { ::close(_fd); }
+
+    [[nodiscard]] uint16_t port() const { return _port; }
+
+    /**
+     * Wait for one datagram
+     * @return False on timeout
+     */
+    bool receive() { return ::recv(_fd, _buffer, sizeof(_buffer), 0) > 0; }
+
+    /**
+     * Drop datagrams sent during camera startup
+     */
+    void drain() {
+        while (::recv(_fd, _buffer, sizeof(_buffer), MSG_DONTWAIT) > 0) {
+        }
+    }
+
+private:
+    int      _fd{-1};
+    uint16_t _port{0};
+    uint8_t  _buffer[2048]{};
+};
+
+/**
+ * Measure call duration and call-to-receive latency of a send path
+ */
+template<typename Send>
+void measure(const std::string& name, Receiver& receiver, Send&& send) {
+    std::vector<std::chrono::nanoseconds> callSamples;
+    std::vector<std::chrono::nanoseconds> deliverySamples;
+    callSamples.reserve(kSamples);
+    deliverySamples.reserve(kSamples);
+
+    const auto allocationsBefore = allocationCount();
+    for (size_t i = 0; i < kSamples; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        send();
+        const auto returned = std::chrono::steady_clock::now();
+        if (!receiver.receive()) {
+            std::printf("%s: datagram lost\n", name.c_str());
+            return;
+        }
+        const auto received = std::chrono::steady_clock::now();
+        callSamples.push_back(returned - start);
+        deliverySamples.push_back(received - start);
+    }
+    // Both vectors were reserved, remaining allocations belong to the send path
+    const auto allocations = static_cast<double>(allocationCount() - allocationsBefore) / kSamples;
+
+    reportLatency(name + " call", callSamples, allocations);
+    reportLatency(name + " delivery", deliverySamples, allocations);
+}
+} // namespace
+
+void runRealtimeBenchmarks() {
+    Receiver      receiver;
+    CameraManager manager(0);
+    auto*         camera = manager.addCamera("127.0.0.1", receiver.port());
+    auto          sender = camera->createRealtimeSender();
+
+    // Hardware ID request is sent at startup
+    receiver.receive();
+    receiver.drain();
+
+    // Queued signal to the communication thread, then QUdpSocket::writeDatagram
+    measure("Signal path takePhoto", receiver, [&] { doNotOptimize(camera->takePhoto()); });
+
+    // Encode on the stack and sendto() from the calling thread
+    const uint8_t photo = 0;
+    measure("RealtimeSender send", receiver, [&] { doNotOptimize(sender->send(Command::PHOTO_VIDEO_HDR, &photo, sizeof(photo))); });
+}
+
+} // namespace siyi::bench
@@ -0,0 +1,86 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+#include <QDir>
+
+#include "CameraManager.h"
+#include "CaptureRecorder.h"
+#include "Codec.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr uint64_t kFrames{1'000'000};
+constexpr auto     kRecordName = "CaptureRecorder::record";
+constexpr auto     kReplayName = "CameraManager::replayCapture as fast as possible";
+
+/**
+ * Encoded attitude push frame
+ */
+FrameBuffer attitudeFrame() {
+    const uint8_t payload[12]{0x10, 0x00, 0xF6, 0xFF, 0x05, 0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00};
+    FrameBuffer   frame;
+    encodeFrame(frame, 0, Command::ACQUIRE_GIMBAL_ATT, payload, sizeof(payload));
+    return frame;
+}
+
+/**
+ * Record attitude frames of camera 0, as the communication thread does
+ */
+void recordCapture(const QString& path) {
+    auto recorder = CaptureRecorder::open(path);
+    if (!recorder) {
+        std::printf("Cannot create %s\n", path.toLocal8Bit().constData());
+        return;
+    }
+    const auto frame  = attitudeFrame();
+    const auto record = [&] {
+        recorder->record(capture::Direction::Received, 0, frame.data(), frame.size(), CaptureRecorder::Clock::now());
+    };
+    // Replay needs the capture even if recording is filtered out
+    if (!run(kRecordName, kFrames, record, frame.size()).iterations) {
+        for (uint64_t i = 0; i < kFrames; ++i) {
+            record();
+        }
+    }
+
+    const auto stats = recorder->close();
+    if (stats.droppedRecords > 0) {
+        std::printf("%s: %llu of %llu frames dropped\n",
+                    kRecordName,
+                    static_cast<unsigned long long>(stats.droppedRecords),
+                    static_cast<unsigned long long>(stats.records + stats.droppedRecords));
+    }
+}
+
+/**
+ * Replay the capture through decode, parser and CameraApi handlers of one camera
+ */
+void replayCapture(const QString& path) {
+    if (!enabled(kReplayName)) {
+        return;
+    }
+
+    CameraManager manager(0);
+    manager.addCamera("127.0.0.1", 9);
+    const auto stats = manager.replayCapture(path, ReplaySpeed::AsFastAsPossible).get();
+    if (!stats.ok()) {
+        std::printf("%s: cannot replay %s\n", kReplayName, path.toLocal8Bit().constData());
+        return;
+    }
+    reportRate(kReplayName, static_cast<double>(stats.framesReplayed) / std::chrono::duration<double>(stats.elapsed).count(), "frames");
+}
+} // namespace
+
+void runReplayBenchmarks() {
+    const auto path = QDir::temp().filePath("siyisdk_bench.cap");
+    if (!enabled(kRecordName) && !enabled(kReplayName)) {
+        return;
+    }
+    recordCapture(path);
+    replayCapture(path);
+    std::remove(path.toLocal8Bit().constData());
+}
+
+} // namespace siyi::bench
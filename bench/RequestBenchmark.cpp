@@ -0,0 +1,78 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+#include "Codec.h"
+#include "MessageBuilder.h"
+#include "RequestTracker.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr uint64_t kIterations{1'000'000};
+constexpr uint8_t  kFeedbackPhotoSuccess{0};
+constexpr uint8_t  kFeedbackHdrOn{2};
+constexpr uint16_t kUnmatchedSequence{0xFFFF}; // Carried by neither request
+
+/**
+ * Acknowledge frame, decoded in place
+ */
+struct Acknowledge {
+    Acknowledge(Command command, uint16_t sequenceNumber, uint8_t value) {
+        encodeFrame(frame, sequenceNumber, command, &value, sizeof(value));
+        view = MessageBuilder::decode(frame.data(), frame.size());
+    }
+
+    FrameBuffer frame;
+    FrameView   view;
+};
+
+/**
+ * Send a photo and an HDR request and answer both with acknowledges that do not echo their sequence numbers
+ * @return True if nothing completed without the fallback, and with it each feedback completed its own request
+ */
+bool checkUnmatchedSequence() {
+    MessageBuilder builder;
+    const auto     now = RequestTracker::Clock::now();
+
+    int            photo = 0;
+    int            hdr   = 0;
+    RequestTracker tracker;
+    tracker.add(builder.buildTakePhotoRequestMessage(), Command::FUNC_FEEDBACK_INFO, {}, [&photo](const RequestResult& result) {
+        photo += result.ok() ? 1 : 0;
+    }, now);
+    tracker.add(builder.buildSwitchHDRRequestMessage(), Command::FUNC_FEEDBACK_INFO, {}, [&hdr](const RequestResult& result) {
+        hdr += result.ok() ? 1 : 0;
+    }, now);
+
+    const Acknowledge hdrOn(Command::FUNC_FEEDBACK_INFO, kUnmatchedSequence, kFeedbackHdrOn);
+    const Acknowledge photoTaken(Command::FUNC_FEEDBACK_INFO, kUnmatchedSequence, kFeedbackPhotoSuccess);
+    const bool        strict = !tracker.complete(hdrOn.view, now) && !tracker.complete(photoTaken.view, now);
+
+    // The HDR feedback arrives first but must not complete the older photo request
+    tracker.setSequenceFallback(true);
+    const bool fallback = tracker.complete(hdrOn.view, now) && hdr == 1 && photo == 0 && tracker.complete(photoTaken.view, now)
+                          && photo == 1 && tracker.empty();
+    return strict && fallback;
+}
+} // namespace
+
+void runRequestBenchmarks() {
+    if (enabled("RequestTracker") && !checkUnmatchedSequence()) {
+        std::printf("RequestTracker: acknowledge without a sequence match completed the wrong request\n");
+    }
+
+    MessageBuilder  builder;
+    RequestTracker  tracker;
+    const auto      request = builder.buildGimbalCenterRequestMessage();
+    const auto      view    = MessageBuilder::decode(request);
+    RequestCallback callback([](const RequestResult& result) { doNotOptimize(result); });
+    Acknowledge     acknowledge(Command::GIMBAL_CENTER, view.sequenceNumber, 1);
+    run("RequestTracker add and complete", kIterations, [&] {
+        const auto now = RequestTracker::Clock::now();
+        tracker.add(request, Command::GIMBAL_CENTER, {}, callback, now);
+        doNotOptimize(tracker.complete(acknowledge.view, now));
+    });
+}
+
+} // namespace siyi::bench
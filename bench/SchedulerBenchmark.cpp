@@ -0,0 +1,75 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "FrameTemplate.h"
+#include "LinkMetrics.h"
+#include "OutboundScheduler.h"
+
+namespace siyi::bench {
+
+namespace {
+constexpr uint64_t kIterations{1'000'000};
+constexpr size_t   kQueuedActions{48}; // Sent over longer than the poll deadline
+
+/**
+ * Queue a poll, many actions and a control frame behind a spent burst and drain at the default rate
+ * @return True if the control frame went first and the poll was dropped once its deadline passed
+ */
+bool checkPriorityOrder() {
+    LinkMetrics       metrics;
+    OutboundScheduler scheduler(metrics);
+    const auto        start = OutboundScheduler::Clock::now();
+
+    FrameBuffer frame;
+    uint16_t    sequence = 0;
+    // Spend the burst so every frame below waits for the rate limit
+    for (size_t i = 0; i < static_cast<size_t>(OutboundScheduler::kBurst); ++i) {
+        templates::kTakePhotoRequest.encode(frame, sequence++);
+        scheduler.enqueue(frame.data(), frame.size(), start);
+    }
+    scheduler.drain(start, [](const FrameBuffer& /*frame*/) {});
+
+    templates::kAcquireGimbalAttitudeRequest.encode(frame, sequence++);
+    scheduler.enqueue(frame.data(), frame.size(), start);
+    for (size_t i = 0; i < kQueuedActions; ++i) {
+        templates::kTakePhotoRequest.encode(frame, sequence++);
+        scheduler.enqueue(frame.data(), frame.size(), start);
+    }
+    templates::kGimbalCenterRequest.encode(frame, sequence++);
+    scheduler.enqueue(frame.data(), frame.size(), start);
+
+    // One frame per period, the poll goes stale behind the actions
+    std::vector<Command> sent;
+    const auto           period = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / OutboundScheduler::kDefaultMaxFrameRate));
+    for (size_t i = 1; scheduler.size() > 0; ++i) {
+        scheduler.drain(start + i * period, [&sent](const FrameBuffer& frame) { sent.push_back(static_cast<Command>(frame.bytes[7])); });
+    }
+
+    const auto  stats      = metrics.snapshot();
+    const auto& background = stats.outbound[static_cast<size_t>(SendPriority::Background)];
+    return sent.size() == kQueuedActions + 1 && sent.front() == Command::GIMBAL_CENTER && sent.back() == Command::PHOTO_VIDEO_HDR
+           && background.staleDrops == 1;
+}
+} // namespace
+
+void runSchedulerBenchmarks() {
+    if (enabled("OutboundScheduler") && !checkPriorityOrder()) {
+        std::printf("OutboundScheduler: control frame did not overtake queued actions, or the stale poll was sent\n");
+    }
+
+    LinkMetrics       metrics;
+    OutboundScheduler scheduler(metrics);
+    scheduler.setMaxFrameRate(0);
+
+    FrameBuffer frame;
+    templates::kTakePhotoRequest.encode(frame, 0);
+    run("OutboundScheduler enqueue and drain", kIterations, [&] {
+        const auto now = OutboundScheduler::Clock::now();
+        scheduler.enqueue(frame.data(), frame.size(), now);
+        scheduler.drain(now, [](const FrameBuffer& sent) { doNotOptimize(sent); });
+    });
+}
+
+} // namespace siyi::bench
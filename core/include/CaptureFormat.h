@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace siyi::capture {
+
+/**
+ * Binary capture of raw link traffic. All multi-byte fields are little-endian.
+ * File: magic "SIYICAP" and a zero byte (8 bytes), version (4 bytes), then records until the end of the file.
+ * Record: frame length (2 bytes), direction (1 byte), camera id (1 byte), monotonic timestamp in ns (8 bytes), frame.
+ */
+constexpr uint8_t  kMagic[]{'S', 'I', 'Y', 'I', 'C', 'A', 'P', '\0'};
+constexpr uint32_t kVersion{1};
+constexpr size_t   kFileHeaderSize{sizeof(kMagic) + 4};
+constexpr size_t   kRecordHeaderSize{12};
+constexpr size_t   kMaxFrameSize{0xFFFF};
+
+/**
+ * Direction of a captured frame as seen by the SDK
+ */
+enum class Direction : uint8_t {
+    Received,
+    Sent,
+};
+
+/**
+ * One captured frame, data references the capture buffer
+ */
+struct Record {
+    uint64_t       timestampNs{0}; // steady_clock, only differences between records are meaningful
+    Direction      direction{Direction::Received};
+    uint8_t        cameraId{0};
+    const uint8_t* data{nullptr};
+    size_t         length{0};
+};
+
+namespace detail {
+constexpr void writeLe(uint8_t* out, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+constexpr uint64_t readLe(const uint8_t* in, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+} // namespace detail
+
+/**
+ * @brief Write the file header
+ * @param out Destination of kFileHeaderSize bytes
+ */
+constexpr void writeFileHeader(uint8_t* out) {
+    for (size_t i = 0; i < sizeof(kMagic); ++i) {
+        out[i] = kMagic[i];
+    }
+    detail::writeLe(out + sizeof(kMagic), kVersion, 4);
+}
+
+/**
+ * @brief Write the header of a record, the frame follows it
+ * @param out Destination of kRecordHeaderSize bytes
+ * @param record Record, length must not exceed kMaxFrameSize
+ */
+constexpr void writeRecordHeader(uint8_t* out, const Record& record) {
+    detail::writeLe(out, record.length, 2);
+    out[2] = static_cast<uint8_t>(record.direction);
+    out[3] = record.cameraId;
+    detail::writeLe(out + 4, record.timestampNs, 8);
+}
+
+/**
+ * Zero-copy iterator over a capture held in memory
+ */
+class Reader {
+public:
+    /**
+     * @param data Whole capture file, must outlive the reader and the records it returns
+     * @param length Capture length
+     */
+    constexpr Reader(const uint8_t* data, size_t length)
+        : _data(data)
+        , _length(length) {
+        if (length < kFileHeaderSize) {
+            return;
+        }
+        for (size_t i = 0; i < sizeof(kMagic); ++i) {
+            if (data[i] != kMagic[i]) {
+                return;
+            }
+        }
+        if (detail::readLe(data + sizeof(kMagic), 4) != kVersion) {
+            return;
+        }
+        _valid  = true;
+        _offset = kFileHeaderSize;
+    }
+
+    /**
+     * @return False if the file header is missing or has an unsupported version
+     */
+    [[nodiscard]] constexpr bool valid() const { return _valid; }
+
+    /**
+     * @return True if the capture ends inside a record, e.g. after a crash of the recording process
+     */
+    [[nodiscard]] constexpr bool truncated() const { return _truncated; }
+
+    /**
+     * @brief Read the next record
+     * @param record Record, valid until the capture buffer is released
+     * @return False at the end of the capture
+     */
+    constexpr bool next(Record& record) {
+        if (!_valid || _length - _offset < kRecordHeaderSize) {
+            _truncated = _valid && _offset != _length;
+            return false;
+        }
+        const auto* header = _data + _offset;
+        const auto  length = static_cast<size_t>(detail::readLe(header, 2));
+        if (_length - _offset - kRecordHeaderSize < length) {
+            _truncated = true;
+            return false;
+        }
+        record.length      = length;
+        record.direction   = static_cast<Direction>(header[2]);
+        record.cameraId    = header[3];
+        record.timestampNs = detail::readLe(header + 4, 8);
+        record.data        = header + kRecordHeaderSize;
+        _offset += kRecordHeaderSize + length;
+        return true;
+    }
+
+private:
+    const uint8_t* _data{nullptr};
+    size_t         _length{0};
+    size_t         _offset{0};
+    bool           _valid{false};
+    bool           _truncated{false};
+};
+
+} // namespace siyi::capture
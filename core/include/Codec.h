@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Command.h"
+#include "Crc16.h"
+#include "Frame.h"
+
+namespace siyi {
+
+/**
+ * @brief Encode a frame into a caller-owned buffer
+ * @param frame Destination buffer, frame.size() holds the encoded length afterwards
+ * @param sequenceNumber Sequence number written into the header
+ * @param command Command to encode
+ * @param data Payload, may be nullptr when dataLength is 0
+ * @param dataLength Payload length, must not exceed FrameBuffer::kMaxPayloadSize
+ * @return True if the frame was encoded, false if the payload does not fit
+ */
+constexpr bool encodeFrame(FrameBuffer& frame, uint16_t sequenceNumber, Command command, const uint8_t* data = nullptr,
+                           size_t dataLength = 0) {
+    if (dataLength > FrameBuffer::kMaxPayloadSize) {
+        frame.length = 0;
+        return false;
+    }
+
+    auto& out = frame.bytes;
+    out[0]    = static_cast<uint8_t>(FrameBuffer::kStx & 0xFF);
+    out[1]    = static_cast<uint8_t>(FrameBuffer::kStx >> 8);
+    out[2]    = 0x01; // control
+    out[3]    = static_cast<uint8_t>(dataLength & 0xFF);
+    out[4]    = static_cast<uint8_t>(dataLength >> 8);
+    out[5]    = static_cast<uint8_t>(sequenceNumber & 0xFF);
+    out[6]    = static_cast<uint8_t>(sequenceNumber >> 8);
+    out[7]    = static_cast<uint8_t>(command);
+    for (size_t i = 0; i < dataLength; ++i) {
+        out[FrameBuffer::kHeaderSize + i] = data[i];
+    }
+
+    const size_t   crcOffset = FrameBuffer::kHeaderSize + dataLength;
+    const uint16_t crc       = crc::calculate(out.data(), crcOffset);
+    out[crcOffset]           = static_cast<uint8_t>(crc & 0xFF);
+    out[crcOffset + 1]       = static_cast<uint8_t>(crc >> 8);
+    frame.length             = crcOffset + FrameBuffer::kCrcSize;
+    return true;
+}
+
+/**
+ * @brief Decode the frame at the start of incoming data without copying it
+ * @param data Received bytes
+ * @param length Number of received bytes
+ * @return View into data, check FrameView::error before use
+ */
+constexpr FrameView decodeFrame(const uint8_t* data, size_t length) {
+    // The message structure is: header (2 bytes), control (1 byte),
+    // data length (2 bytes), sequence number (2 bytes), command code (1 byte), data, CRC (2 bytes)
+    FrameView frame;
+
+    // Check if the message has at least the minimum required length
+    if (length < FrameBuffer::kHeaderSize + FrameBuffer::kCrcSize) {
+        frame.error = DecodeError::TooShort;
+        return frame;
+    }
+
+    // Check the header
+    if (data[0] != (FrameBuffer::kStx & 0xFF) || data[1] != (FrameBuffer::kStx >> 8)) {
+        frame.error = DecodeError::BadStx;
+        return frame;
+    }
+
+    // Extract the control and data length
+    frame.control    = data[2];
+    frame.dataLength = static_cast<uint16_t>(data[3] | (data[4] << 8));
+    frame.frameSize  = FrameBuffer::kHeaderSize + frame.dataLength + FrameBuffer::kCrcSize;
+
+    // Check message length
+    if (frame.frameSize > length) {
+        frame.error = DecodeError::Truncated;
+        return frame;
+    }
+
+    frame.frame          = data;
+    frame.sequenceNumber = static_cast<uint16_t>(data[5] | (data[6] << 8));
+    frame.command        = static_cast<Command>(data[7]);
+    frame.data           = data + FrameBuffer::kHeaderSize;
+
+    // Check if the received CRC matches the CRC calculated over the frame excluding the CRC itself
+    const size_t crcOffset   = FrameBuffer::kHeaderSize + frame.dataLength;
+    const auto   receivedCRC = static_cast<uint16_t>(data[crcOffset] | (data[crcOffset + 1] << 8));
+    if (receivedCRC != crc::calculate(data, crcOffset)) {
+        frame.error = DecodeError::CrcMismatch;
+        return frame;
+    }
+
+    frame.error = DecodeError::None;
+    return frame;
+}
+
+} // namespace siyi
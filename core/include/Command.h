@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstdint>
+
 namespace siyi {
 
-enum class Command : quint8 {
+enum class Command : uint8_t {
     UNKNOWN              = 0x00,
     ACQUIRE_FW_VER       = 0x01,
     ACQUIRE_HW_ID        = 0x02,
@@ -16,7 +18,30 @@ enum class Command : quint8 {
     FUNC_FEEDBACK_INFO   = 0x0b,
     PHOTO_VIDEO_HDR      = 0x0c,
     ACQUIRE_GIMBAL_ATT   = 0x0d,
-    GIMBAL_CONTROL_ANGLE = 0x0E
+    GIMBAL_CONTROL_ANGLE = 0x0E,
+    REQUEST_DATA_STREAM  = 0x25
+};
+
+/**
+ * Data pushed by the gimbal after REQUEST_DATA_STREAM
+ */
+enum class DataStreamType : uint8_t {
+    Attitude   = 1,
+    LaserRange = 2,
+};
+
+/**
+ * Push rate of a data stream
+ */
+enum class DataStreamFrequency : uint8_t {
+    Off   = 0,
+    Hz2   = 1,
+    Hz4   = 2,
+    Hz5   = 3,
+    Hz10  = 4,
+    Hz20  = 5,
+    Hz50  = 6,
+    Hz100 = 7,
 };
 
 } // namespace siyi
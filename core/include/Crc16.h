@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace siyi {
+
+/**
+ * CRC16-CCITT (polynomial 0x1021, no reflection) used by the SIYI frame. Every function is constexpr,
+ * frames can be checksummed at compile time.
+ */
+namespace crc {
+
+/**
+ * CRC16 implementations, all of them produce identical results
+ */
+enum class Kernel {
+    Bytewise, // One table lookup per byte
+    Slicing4, // Four bytes per iteration
+    Slicing8, // Eight bytes per iteration
+};
+
+namespace detail {
+
+inline constexpr uint16_t crc16_tab[256] = {0x0,    0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7, 0x8108, 0x9129, 0xa14a, 0xb16b,
+                                            0xc18c, 0xd1ad, 0xe1ce, 0xf1ef, 0x1231, 0x210,  0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
+                                            0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de, 0x2462, 0x3443, 0x420,  0x1401,
+                                            0x64e6, 0x74c7, 0x44a4, 0x5485, 0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
+                                            0x3653, 0x2672, 0x1611, 0x630,  0x76d7, 0x66f6, 0x5695, 0x46b4, 0xb75b, 0xa77a, 0x9719, 0x8738,
+                                            0xf7df, 0xe7fe, 0xd79d, 0xc7bc, 0x48c4, 0x58e5, 0x6886, 0x78a7, 0x840,  0x1861, 0x2802, 0x3823,
+                                            0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b, 0x5af5, 0x4ad4, 0x7ab7, 0x6a96,
+                                            0x1a71, 0xa50,  0x3a33, 0x2a12, 0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
+                                            0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0xc60,  0x1c41, 0xedae, 0xfd8f, 0xcdec, 0xddcd,
+                                            0xad2a, 0xbd0b, 0x8d68, 0x9d49, 0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0xe70,
+                                            0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78, 0x9188, 0x81a9, 0xb1ca, 0xa1eb,
+                                            0xd10c, 0xc12d, 0xf14e, 0xe16f, 0x1080, 0xa1,   0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
+                                            0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e, 0x2b1,  0x1290, 0x22f3, 0x32d2,
+                                            0x4235, 0x5214, 0x6277, 0x7256, 0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+                                            0x34e2, 0x24c3, 0x14a0, 0x481,  0x7466, 0x6447, 0x5424, 0x4405, 0xa7db, 0xb7fa, 0x8799, 0x97b8,
+                                            0xe75f, 0xf77e, 0xc71d, 0xd73c, 0x26d3, 0x36f2, 0x691,  0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
+                                            0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab, 0x5844, 0x4865, 0x7806, 0x6827,
+                                            0x18c0, 0x8e1,  0x3882, 0x28a3, 0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
+                                            0x4a75, 0x5a54, 0x6a37, 0x7a16, 0xaf1,  0x1ad0, 0x2ab3, 0x3a92, 0xfd2e, 0xed0f, 0xdd6c, 0xcd4d,
+                                            0xbdaa, 0xad8b, 0x9de8, 0x8dc9, 0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0xcc1,
+                                            0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8, 0x6e17, 0x7e36, 0x4e55, 0x5e74,
+                                            0x2e93, 0x3eb2, 0xed1,  0x1ef0};
+
+inline constexpr uint16_t kPolynomial{0x1021};
+
+// Shortest input for which the slicing kernels beat the bytewise loop
+inline constexpr size_t kSlicingThreshold{8};
+
+using Table = std::array<uint16_t, 256>;
+
+constexpr bool tableMatchesPolynomial() {
+    for (uint16_t i = 0; i < 256; ++i) {
+        uint16_t crc = static_cast<uint16_t>(i << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ kPolynomial) : static_cast<uint16_t>(crc << 1);
+        }
+        if (crc != crc16_tab[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(tableMatchesPolynomial(), "crc16_tab must be the CRC16-CCITT table");
+
+// tables[k][b] is the CRC of byte b followed by k zero bytes
+constexpr std::array<Table, 8> makeSlicingTables() {
+    std::array<Table, 8> tables{};
+    for (size_t i = 0; i < 256; ++i) {
+        tables[0][i] = crc16_tab[i];
+    }
+    for (size_t k = 1; k < tables.size(); ++k) {
+        for (size_t i = 0; i < 256; ++i) {
+            const uint16_t previous = tables[k - 1][i];
+            tables[k][i]            = static_cast<uint16_t>((previous << 8) ^ crc16_tab[previous >> 8]);
+        }
+    }
+    return tables;
+}
+
+inline constexpr std::array<Table, 8> slicingTables = makeSlicingTables();
+
+constexpr uint16_t bytewise(const uint8_t* data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; ++i) {
+        const uint8_t  temp     = (crc >> 8) & 0xFF;
+        const uint16_t oldcrc16 = crc16_tab[data[i] ^ temp];
+        crc                     = static_cast<uint16_t>((crc << 8) ^ oldcrc16);
+    }
+    return crc;
+}
+
+constexpr uint16_t slicing4(const uint8_t* data, size_t length, uint16_t crc) {
+    const auto& t = slicingTables;
+    while (length >= 4) {
+        crc ^= static_cast<uint16_t>((data[0] << 8) | data[1]);
+        crc = static_cast<uint16_t>(t[3][crc >> 8] ^ t[2][crc & 0xFF] ^ t[1][data[2]] ^ t[0][data[3]]);
+        data += 4;
+        length -= 4;
+    }
+    return bytewise(data, length, crc);
+}
+
+constexpr uint16_t slicing8(const uint8_t* data, size_t length, uint16_t crc) {
+    const auto& t = slicingTables;
+    while (length >= 8) {
+        crc ^= static_cast<uint16_t>((data[0] << 8) | data[1]);
+        crc = static_cast<uint16_t>(t[7][crc >> 8] ^ t[6][crc & 0xFF] ^ t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]]
+                                    ^ t[1][data[6]] ^ t[0][data[7]]);
+        data += 8;
+        length -= 8;
+    }
+    return bytewise(data, length, crc);
+}
+
+} // namespace detail
+
+/**
+ * @brief Calculate CRC16 with the specified kernel
+ * @param data Data to checksum
+ * @param length Data length
+ * @param init Initial CRC state, pass the result of a previous call to continue a checksum
+ * @param kernel Implementation
+ * @return CRC16 state after processing the data
+ */
+constexpr uint16_t calculate(const uint8_t* data, size_t length, uint16_t init, Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Slicing4:
+        return detail::slicing4(data, length, init);
+    case Kernel::Slicing8:
+        return detail::slicing8(data, length, init);
+    case Kernel::Bytewise:
+    default:
+        return detail::bytewise(data, length, init);
+    }
+}
+
+/**
+ * @brief Calculate CRC16 picking the fastest kernel for the data length
+ */
+constexpr uint16_t calculate(const uint8_t* data, size_t length, uint16_t init = 0) {
+    return calculate(data, length, init, length < detail::kSlicingThreshold ? Kernel::Bytewise : Kernel::Slicing8);
+}
+
+} // namespace crc
+
+/**
+ * Incremental CRC16 state. A checksum can be resumed from a precomputed prefix state.
+ */
+class Crc16 {
+public:
+    constexpr explicit Crc16(uint16_t state = 0)
+        : _state(state) {}
+
+    constexpr Crc16& update(const uint8_t* data, size_t length) {
+        _state = crc::calculate(data, length, _state);
+        return *this;
+    }
+
+    [[nodiscard]] constexpr uint16_t value() const { return _state; }
+
+private:
+    uint16_t _state;
+};
+
+} // namespace siyi
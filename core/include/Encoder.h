@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Codec.h"
+#include "Command.h"
+#include "Frame.h"
+#include "FrameTemplate.h"
+
+namespace siyi {
+
+/**
+ * Plain sequence counter for single-threaded use, wraps around after 65535
+ */
+class SequenceCounter {
+public:
+    constexpr uint16_t next() { return _value++; }
+
+private:
+    uint16_t _value{0};
+};
+
+/**
+ * Builds request frames of one camera into caller-owned buffers.
+ * @tparam Sequence Provides uint16_t next(), swap in an atomic counter when frames are built on several threads
+ */
+template<typename Sequence = SequenceCounter>
+class Encoder {
+public:
+    constexpr void buildFirmwareRequestMessage(FrameBuffer& frame) { encode(frame, templates::kFirmwareRequest); }
+    constexpr void buildHardwareIDRequestMessage(FrameBuffer& frame) { encode(frame, templates::kHardwareIDRequest); }
+
+    // Zoom
+    constexpr void buildManualZoomRequestMessage(FrameBuffer& frame, int8_t direction) {
+        encodeByte(frame, Command::MANUAL_ZOOM, static_cast<uint8_t>(clampDirection(direction)));
+    }
+    constexpr void buildAbsoluteZoomRequestMessage(FrameBuffer& frame, uint8_t zoomLevel) {
+        encodeByte(frame, Command::ABSOLUTE_ZOOM, zoomLevel);
+    }
+
+    // Focus
+    constexpr void buildAutoFocusRequestMessage(FrameBuffer& frame) { encode(frame, templates::kAutoFocusRequest); }
+    constexpr void buildManualFocusShotRequestMessage(FrameBuffer& frame, int8_t direction) {
+        encodeByte(frame, Command::MANUAL_FOCUS, static_cast<uint8_t>(clampDirection(direction)));
+    }
+
+    /**
+     * Build gimbal rotation request message
+     * @param frame Destination buffer
+     * @param yawSpeed Yaw speed [-100, 100]
+     * @param pitchSpeed Pitch speed [-100, 100]
+     */
+    constexpr void buildGimbalRotationRequestMessage(FrameBuffer& frame, int8_t yawSpeed, int8_t pitchSpeed) {
+        const uint8_t data[] = {static_cast<uint8_t>(yawSpeed), static_cast<uint8_t>(pitchSpeed)};
+        encode(frame, Command::GIMBAL_ROTATION, data, sizeof(data));
+    }
+
+    constexpr void buildGimbalCenterRequestMessage(FrameBuffer& frame) { encode(frame, templates::kGimbalCenterRequest); }
+
+    /**
+     * Build gimbal set angle request message
+     * @param frame Destination buffer
+     * @param yawAngle Target yaw angle in 0.1 degrees
+     * @param pitchAngle Target pitch angle in 0.1 degrees
+     */
+    constexpr void buildSetGimbalControlAngleRequestMessage(FrameBuffer& frame, int16_t yawAngle, int16_t pitchAngle) {
+        // Angles are little-endian on the wire, like every other multi-byte field of the protocol
+        const auto    yaw    = static_cast<uint16_t>(yawAngle);
+        const auto    pitch  = static_cast<uint16_t>(pitchAngle);
+        const uint8_t data[] = {static_cast<uint8_t>(yaw & 0xFF),
+                                static_cast<uint8_t>(yaw >> 8),
+                                static_cast<uint8_t>(pitch & 0xFF),
+                                static_cast<uint8_t>(pitch >> 8)};
+        encode(frame, Command::GIMBAL_CONTROL_ANGLE, data, sizeof(data));
+    }
+
+    constexpr void buildAcquireGimbalAttitudeRequestMessage(FrameBuffer& frame) { encode(frame, templates::kAcquireGimbalAttitudeRequest); }
+
+    // Photo and Video
+    constexpr void buildTakePhotoRequestMessage(FrameBuffer& frame) { encode(frame, templates::kTakePhotoRequest); }
+    constexpr void buildSwitchHDRRequestMessage(FrameBuffer& frame) { encode(frame, templates::kSwitchHDRRequest); }
+    constexpr void buildStartStopRecordingRequestMessage(FrameBuffer& frame) { encode(frame, templates::kStartStopRecordingRequest); }
+    constexpr void buildMotionLockModeRequestMessage(FrameBuffer& frame) { encode(frame, templates::kMotionLockModeRequest); }
+    constexpr void buildMotionFollowModeRequestMessage(FrameBuffer& frame) { encode(frame, templates::kMotionFollowModeRequest); }
+    constexpr void buildMotionFPVModeRequestMessage(FrameBuffer& frame) { encode(frame, templates::kMotionFPVModeRequest); }
+    constexpr void buildSetVideoOutputHDMIRequestMessage(FrameBuffer& frame) { encode(frame, templates::kSetVideoOutputHDMIRequest); }
+    constexpr void buildSetVideoOutputCVBSRequestMessage(FrameBuffer& frame) { encode(frame, templates::kSetVideoOutputCVBSRequest); }
+
+    constexpr void buildAcquireGimbalInfoRequestMessage(FrameBuffer& frame) { encode(frame, templates::kAcquireGimbalInfoRequest); }
+
+    /**
+     * Request gimbal to push data at a fixed rate
+     * @param frame Destination buffer
+     * @param type Data to push
+     * @param frequency Push rate, DataStreamFrequency::Off stops the stream
+     */
+    constexpr void buildDataStreamRequestMessage(FrameBuffer& frame, DataStreamType type, DataStreamFrequency frequency) {
+        const uint8_t data[] = {static_cast<uint8_t>(type), static_cast<uint8_t>(frequency)};
+        encode(frame, Command::REQUEST_DATA_STREAM, data, sizeof(data));
+    }
+
+    /**
+     * @brief Encode any command with the next sequence number
+     * @param frame Destination buffer
+     * @param command Command to encode
+     * @param data Payload, may be nullptr when dataLength is 0
+     * @param dataLength Payload length, must not exceed FrameBuffer::kMaxPayloadSize
+     * @return True if the frame was encoded, false if the payload does not fit
+     */
+    constexpr bool encode(FrameBuffer& frame, Command command, const uint8_t* data = nullptr, size_t dataLength = 0) {
+        // Rejected frames do not consume a sequence number
+        if (dataLength > FrameBuffer::kMaxPayloadSize) {
+            frame.length = 0;
+            return false;
+        }
+        return encodeFrame(frame, _sequence.next(), command, data, dataLength);
+    }
+
+    /**
+     * @brief Encode a constant frame with the next sequence number
+     * @param frame Destination buffer
+     * @param frameTemplate Pre-encoded frame
+     */
+    constexpr void encode(FrameBuffer& frame, const FrameTemplate& frameTemplate) { frameTemplate.encode(frame, _sequence.next()); }
+
+private:
+    constexpr void encodeByte(FrameBuffer& frame, Command command, uint8_t value) { encode(frame, command, &value, sizeof(value)); }
+
+    static constexpr int8_t clampDirection(int8_t direction) {
+        if (direction > 1) {
+            return 1;
+        }
+        if (direction < -1) {
+            return -1;
+        }
+        return direction;
+    }
+
+private:
+    Sequence _sequence{};
+};
+
+} // namespace siyi
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace siyi {
+
+/**
+ * Wire types for fields that need more than a little-endian integer read
+ */
+struct InvertedFlag {}; // uint8, 0 means true
+struct AsciiHexByte {}; // Two ASCII hex digits, e.g. "6B" -> 0x6B
+struct Remaining {};    // Rest of the payload, copied into FixedBytes
+
+/**
+ * Byte string of bounded size stored inline, used instead of heap-backed strings
+ */
+template<size_t N>
+struct FixedBytes {
+    [[nodiscard]] constexpr const uint8_t* data() const { return bytes.data(); }
+    [[nodiscard]] constexpr size_t         size() const { return length; }
+
+    std::array<uint8_t, N> bytes{};
+    size_t                 length{0};
+};
+
+/**
+ * Reads a value of wire type Wire into a message field.
+ * Default: little-endian integer converted to the field type.
+ */
+template<typename Wire>
+struct WireCodec {
+    static_assert(std::is_integral_v<Wire>, "WireCodec must be specialized for non-integral wire types");
+
+    static constexpr size_t size = sizeof(Wire);
+
+    template<typename T>
+    static constexpr void read(const uint8_t* data, size_t /*length*/, T& value) {
+        std::make_unsigned_t<Wire> raw = 0;
+        for (size_t i = 0; i < size; ++i) {
+            raw |= static_cast<std::make_unsigned_t<Wire>>(static_cast<std::make_unsigned_t<Wire>>(data[i]) << (8 * i));
+        }
+        value = static_cast<T>(static_cast<Wire>(raw));
+    }
+};
+
+template<>
+struct WireCodec<InvertedFlag> {
+    static constexpr size_t size = 1;
+
+    static constexpr void read(const uint8_t* data, size_t /*length*/, bool& value) { value = data[0] == 0; }
+};
+
+template<>
+struct WireCodec<AsciiHexByte> {
+    static constexpr size_t size = 2;
+
+    template<typename T>
+    static constexpr void read(const uint8_t* data, size_t /*length*/, T& value) {
+        value = static_cast<T>((nibble(data[0]) << 4) | nibble(data[1]));
+    }
+
+private:
+    static constexpr uint8_t nibble(uint8_t c) {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return 0;
+    }
+};
+
+template<>
+struct WireCodec<Remaining> {
+    static constexpr size_t size = 0;
+
+    template<size_t N>
+    static constexpr void read(const uint8_t* data, size_t length, FixedBytes<N>& value) {
+        value.length = std::min(length, N);
+        for (size_t i = 0; i < value.length; ++i) {
+            value.bytes[i] = data[i];
+        }
+    }
+};
+
+namespace detail {
+template<typename>
+struct MemberTraits;
+
+template<typename Class, typename T>
+struct MemberTraits<T Class::*> {
+    using Type = T;
+};
+
+// Enums are read through their underlying type unless a wire type is given
+template<typename T, bool = std::is_enum_v<T>>
+struct DefaultWire {
+    using Type = T;
+};
+
+template<typename T>
+struct DefaultWire<T, true> {
+    using Type = std::underlying_type_t<T>;
+};
+} // namespace detail
+
+/**
+ * One field of a message payload
+ * @tparam Member Pointer to the message member
+ * @tparam Offset Byte offset in the payload
+ * @tparam Wire Wire type, defaults to the member type
+ */
+template<auto Member,
+         size_t Offset,
+         typename Wire = typename detail::DefaultWire<typename detail::MemberTraits<decltype(Member)>::Type>::Type>
+struct Field {
+    static constexpr size_t end = Offset + WireCodec<Wire>::size;
+
+    template<typename Message>
+    static constexpr void read(const uint8_t* data, size_t length, Message& message) {
+        WireCodec<Wire>::read(data + Offset, length - Offset, message.*Member);
+    }
+};
+
+/**
+ * Field that older firmware may omit, it is left untouched if the payload ends before it
+ * @tparam Member Pointer to the message member
+ * @tparam Offset Byte offset in the payload
+ * @tparam Wire Wire type, defaults to the member type
+ */
+template<auto Member,
+         size_t Offset,
+         typename Wire = typename detail::DefaultWire<typename detail::MemberTraits<decltype(Member)>::Type>::Type>
+struct OptionalField {
+    static constexpr size_t end = 0; // Not part of the minimal payload
+
+    template<typename Message>
+    static constexpr void read(const uint8_t* data, size_t length, Message& message) {
+        if (length >= Offset + WireCodec<Wire>::size) {
+            WireCodec<Wire>::read(data + Offset, length - Offset, message.*Member);
+        }
+    }
+};
+
+/**
+ * Compile-time little-endian payload layout of a message
+ */
+template<typename... Fields>
+struct FieldLayout {
+    // Minimal payload length that contains every field
+    static constexpr size_t size = std::max({size_t{0}, Fields::end...});
+
+    /**
+     * @brief Read payload into message
+     * @param data Payload
+     * @param length Payload length
+     * @param message Message to fill
+     * @return False if the payload is too short for the layout
+     */
+    template<typename Message>
+    static constexpr bool read(const uint8_t* data, size_t length, Message& message) {
+        if (length < size) {
+            return false;
+        }
+        (Fields::read(data, length, message), ...);
+        return true;
+    }
+};
+
+} // namespace siyi
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Command.h"
+
+namespace siyi {
+
+/**
+ * Fixed-size, caller-owned storage for one encoded outgoing frame.
+ * Layout: header (2 bytes), control (1 byte), data length (2 bytes), sequence number (2 bytes),
+ * command code (1 byte), data, CRC (2 bytes). All multi-byte fields are little-endian.
+ */
+struct FrameBuffer {
+    static constexpr uint16_t kStx            = 0x6655;
+    static constexpr size_t   kHeaderSize     = 8;
+    static constexpr size_t   kCrcSize        = 2;
+    static constexpr size_t   kMaxPayloadSize = 32;
+    static constexpr size_t   kCapacity       = kHeaderSize + kMaxPayloadSize + kCrcSize;
+
+    [[nodiscard]] constexpr const uint8_t* data() const { return bytes.data(); }
+    [[nodiscard]] constexpr size_t         size() const { return length; }
+
+    std::array<uint8_t, kCapacity> bytes{};
+    size_t                         length{0};
+};
+
+/**
+ * Reason a received frame was rejected
+ */
+enum class DecodeError : uint8_t {
+    None,        // Frame is valid
+    TooShort,    // Less bytes than the smallest possible frame
+    BadStx,      // Frame does not start with 0x55 0x66
+    Truncated,   // Data length field points past the end of the buffer
+    CrcMismatch, // Received CRC does not match calculated CRC
+};
+
+/**
+ * Decoded frame referencing the receive buffer, the buffer must outlive the view
+ */
+struct FrameView {
+    [[nodiscard]] constexpr bool valid() const { return error == DecodeError::None; }
+
+    const uint8_t* frame{nullptr}; // Whole frame including header and CRC
+    size_t         frameSize{0};
+    uint8_t        control{0};
+    uint16_t       sequenceNumber{0};
+    Command        command{Command::UNKNOWN};
+    const uint8_t* data{nullptr}; // Payload
+    size_t         dataLength{0};
+    DecodeError    error{DecodeError::TooShort};
+};
+
+} // namespace siyi
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Codec.h"
+#include "Command.h"
+#include "Crc16.h"
+#include "Frame.h"
+
+namespace siyi {
+
+/**
+ * Frame of a command with a constant payload, encoded once at compile time.
+ * Only the sequence number differs between two sends. The CRC has no init value or final XOR, so it is linear in
+ * the frame bytes: the CRC of a send is the CRC of the template with sequence number 0, XORed with the contribution
+ * of the two sequence bytes taken from the slicing tables. Encoding is a copy, two byte stores and two independent
+ * table lookups, and the result is identical to encodeFrame().
+ */
+class FrameTemplate {
+public:
+    static constexpr size_t kSequenceOffset = 5;
+    // The slicing tables cover a byte followed by at most 7 zero bytes: command, payload and the high sequence byte
+    static constexpr size_t kMaxDataLength = crc::detail::slicingTables.size() - 3;
+
+    /**
+     * @param command Command to encode
+     * @param data Payload, may be nullptr when dataLength is 0
+     * @param dataLength Payload length, a longer payload makes an empty template
+     */
+    constexpr explicit FrameTemplate(Command command, const uint8_t* data = nullptr, size_t dataLength = 0) {
+        if (dataLength > kMaxDataLength) {
+            return;
+        }
+        encodeFrame(_frame, 0, command, data, dataLength);
+        _crc      = crc::calculate(_frame.data(), FrameBuffer::kHeaderSize + dataLength);
+        _trailing = 1 + dataLength;
+    }
+
+    /**
+     * @param command Command to encode
+     * @param value Single payload byte
+     */
+    constexpr FrameTemplate(Command command, uint8_t value)
+        : FrameTemplate(command, &value, sizeof(value)) {}
+
+    /**
+     * @brief Encode the frame with a sequence number
+     * @param frame Destination buffer, empty if the template is empty
+     * @param sequenceNumber Sequence number of the frame
+     */
+    constexpr void encode(FrameBuffer& frame, uint16_t sequenceNumber) const {
+        frame = _frame;
+        if (frame.length == 0) {
+            return;
+        }
+        const auto  low          = static_cast<uint8_t>(sequenceNumber & 0xFF);
+        const auto  high         = static_cast<uint8_t>(sequenceNumber >> 8);
+        auto&       out          = frame.bytes;
+        out[kSequenceOffset]     = low;
+        out[kSequenceOffset + 1] = high;
+
+        const auto& tables    = crc::detail::slicingTables;
+        const auto  crc       = static_cast<uint16_t>(_crc ^ tables[_trailing + 1][low] ^ tables[_trailing][high]);
+        const auto  crcOffset = frame.length - FrameBuffer::kCrcSize;
+        out[crcOffset]        = static_cast<uint8_t>(crc & 0xFF);
+        out[crcOffset + 1]    = static_cast<uint8_t>(crc >> 8);
+    }
+
+    [[nodiscard]] constexpr Command command() const { return static_cast<Command>(_frame.bytes[7]); }
+    [[nodiscard]] constexpr size_t  size() const { return _frame.length; }
+
+private:
+    FrameBuffer _frame;       // Encoded with sequence number 0
+    uint16_t    _crc{0};      // CRC of _frame
+    size_t      _trailing{0}; // Bytes between the sequence number and the CRC
+};
+
+/**
+ * Frames of the commands without variable fields
+ */
+namespace templates {
+inline constexpr FrameTemplate kFirmwareRequest{Command::ACQUIRE_FW_VER};
+inline constexpr FrameTemplate kHardwareIDRequest{Command::ACQUIRE_HW_ID};
+inline constexpr FrameTemplate kAutoFocusRequest{Command::AUTO_FOCUS, uint8_t{1}};
+inline constexpr FrameTemplate kGimbalCenterRequest{Command::GIMBAL_CENTER, uint8_t{1}};
+inline constexpr FrameTemplate kAcquireGimbalAttitudeRequest{Command::ACQUIRE_GIMBAL_ATT};
+inline constexpr FrameTemplate kAcquireGimbalInfoRequest{Command::ACQUIRE_GIMBAL_INFO};
+inline constexpr FrameTemplate kTakePhotoRequest{Command::PHOTO_VIDEO_HDR, uint8_t{0}};
+inline constexpr FrameTemplate kSwitchHDRRequest{Command::PHOTO_VIDEO_HDR, uint8_t{1}};
+inline constexpr FrameTemplate kStartStopRecordingRequest{Command::PHOTO_VIDEO_HDR, uint8_t{2}};
+inline constexpr FrameTemplate kMotionLockModeRequest{Command::PHOTO_VIDEO_HDR, uint8_t{3}};
+inline constexpr FrameTemplate kMotionFollowModeRequest{Command::PHOTO_VIDEO_HDR, uint8_t{4}};
+inline constexpr FrameTemplate kMotionFPVModeRequest{Command::PHOTO_VIDEO_HDR, uint8_t{5}};
+inline constexpr FrameTemplate kSetVideoOutputHDMIRequest{Command::PHOTO_VIDEO_HDR, uint8_t{6}};
+inline constexpr FrameTemplate kSetVideoOutputCVBSRequest{Command::PHOTO_VIDEO_HDR, uint8_t{7}};
+} // namespace templates
+
+} // namespace siyi
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Frame.h"
+#include "Messages.h"
+
+namespace siyi {
+
+/**
+ * Compile-time list of message types
+ */
+template<typename... Messages>
+struct MessageList {};
+
+// Every message the protocol core can parse
+using KnownMessages = MessageList<FirmwareMessage,
+                                  HardwareIDMessage,
+                                  AutoFocusMessage,
+                                  ManualZoomMessage,
+                                  AbsoluteZoomMessage,
+                                  ManualFocusMessage,
+                                  GimbalRotationMessage,
+                                  GimbalCenterMessage,
+                                  FunctionFeedbackMessage,
+                                  GimbalAttitudeMessage,
+                                  GimbalControlAngleMessage,
+                                  CameraStatusInfoMessage,
+                                  DataStreamMessage>;
+
+/**
+ * @brief Parse payload of a decoded frame
+ * @param frame Valid frame
+ * @param message Message to fill
+ * @return False if the frame carries another command or the payload is too short
+ */
+template<typename Message>
+constexpr bool parseMessage(const FrameView& frame, Message& message) {
+    return frame.command == Message::kCommand && Message::Layout::read(frame.data, frame.dataLength, message);
+}
+
+namespace detail {
+template<typename Message, typename Visitor>
+constexpr bool visitIf(const FrameView& frame, Visitor& visitor, bool& parsed) {
+    if (frame.command != Message::kCommand) {
+        return false;
+    }
+    Message message;
+    parsed = Message::Layout::read(frame.data, frame.dataLength, message);
+    if (parsed) {
+        visitor(message);
+    }
+    return true;
+}
+
+template<typename Visitor, typename... Messages>
+constexpr bool dispatch(const FrameView& frame, Visitor& visitor, MessageList<Messages...> /*messages*/) {
+    bool parsed = false;
+    (visitIf<Messages>(frame, visitor, parsed) || ...);
+    return parsed;
+}
+} // namespace detail
+
+/**
+ * @brief Parse a decoded frame into its message type and pass it to visitor
+ * @param frame Valid frame
+ * @param visitor Called as visitor(const Message&) with the parsed message, e.g. an overloaded lambda
+ * @return False if the command is unknown or the payload is too short
+ */
+template<typename Visitor>
+constexpr bool dispatchMessage(const FrameView& frame, Visitor&& visitor) {
+    return detail::dispatch(frame, visitor, KnownMessages{});
+}
+
+} // namespace siyi
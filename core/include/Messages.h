@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Command.h"
+#include "FieldLayout.h"
+
+/**
+ * The FirmwareMessage
+ */
+struct FirmwareMessage {
+    uint32_t boardVersion{0};
+    uint32_t gimbalFirmwareVersion{0};
+    uint32_t zoomFirmwareVersion{0};
+
+    static constexpr siyi::Command kCommand = siyi::Command::ACQUIRE_FW_VER;
+    using Layout = siyi::FieldLayout<siyi::Field<&FirmwareMessage::boardVersion, 0>,
+                                     siyi::Field<&FirmwareMessage::gimbalFirmwareVersion, 4>,
+                                     siyi::Field<&FirmwareMessage::zoomFirmwareVersion, 8>>;
+};
+
+/**
+ * The HardwareIDMessage
+ */
+struct HardwareIDMessage {
+    siyi::FixedBytes<12> hardwareID; // Raw id bytes
+    uint16_t             modelId{};
+
+    static constexpr siyi::Command kCommand = siyi::Command::ACQUIRE_HW_ID;
+    using Layout = siyi::FieldLayout<siyi::Field<&HardwareIDMessage::hardwareID, 0, siyi::Remaining>,
+                                     siyi::Field<&HardwareIDMessage::modelId, 0, siyi::AsciiHexByte>>;
+};
+
+/**
+ * The AutoFocusMessage
+ */
+struct AutoFocusMessage {
+    bool success{false};
+
+    static constexpr siyi::Command kCommand = siyi::Command::AUTO_FOCUS;
+    using Layout = siyi::FieldLayout<siyi::Field<&AutoFocusMessage::success, 0, uint8_t>>;
+};
+
+/**
+ * The ManualZoomMessage
+ */
+struct ManualZoomMessage {
+    [[nodiscard]] float actualZoom() const { return static_cast<float>(zoomLevel) / 10.0f; }
+
+    uint16_t zoomLevel{0};
+
+    static constexpr siyi::Command kCommand = siyi::Command::MANUAL_ZOOM;
+    using Layout = siyi::FieldLayout<siyi::Field<&ManualZoomMessage::zoomLevel, 0>>;
+};
+
+/**
+ * The AbsoluteZoomMessage
+ */
+
+struct AbsoluteZoomMessage {
+    uint8_t absoluteMovementAsk{0};
+
+    static constexpr siyi::Command kCommand = siyi::Command::ABSOLUTE_ZOOM;
+    using Layout = siyi::FieldLayout<siyi::Field<&AbsoluteZoomMessage::absoluteMovementAsk, 0>>;
+};
+
+/**
+ * The ManualFocusMessage
+ */
+struct ManualFocusMessage {
+    uint8_t state{0}; // 1: Success, 0: Fail
+
+    static constexpr siyi::Command kCommand = siyi::Command::MANUAL_FOCUS;
+    using Layout = siyi::FieldLayout<siyi::Field<&ManualFocusMessage::state, 0>>;
+};
+
+/**
+ * The GimbalRotationMessage
+ */
+struct GimbalRotationMessage {
+    uint8_t state{0}; // 1: Success, 0: Fail
+
+    static constexpr siyi::Command kCommand = siyi::Command::GIMBAL_ROTATION;
+    using Layout = siyi::FieldLayout<siyi::Field<&GimbalRotationMessage::state, 0>>;
+};
+
+/**
+ * The CenterMessage
+ */
+
+struct GimbalCenterMessage {
+    uint8_t state{0}; // 1: Success, 0: Fail
+
+    static constexpr siyi::Command kCommand = siyi::Command::GIMBAL_CENTER;
+    using Layout = siyi::FieldLayout<siyi::Field<&GimbalCenterMessage::state, 0>>;
+};
+
+/**
+ * The FunctionFeedbackMessage
+ */
+struct FunctionFeedbackMessage {
+    // 0: Success
+    // 1: Fail to take a photo (Please check
+    // if TF card is inserted)
+    // 2: HDR ON
+    // 3: HDR OFF
+    // 4: Fail to record a video (Please check
+    // if TF card is inserted)
+    uint8_t state{0};
+
+    static constexpr siyi::Command kCommand = siyi::Command::FUNC_FEEDBACK_INFO;
+    using Layout = siyi::FieldLayout<siyi::Field<&FunctionFeedbackMessage::state, 0>>;
+};
+
+/**
+ * The GimbalAttitudeMessage
+ */
+struct GimbalAttitudeMessage {
+    [[nodiscard]] float actualYaw() const { return static_cast<float>(yaw) / 10.0f; }
+    [[nodiscard]] float actualPitch() const { return static_cast<float>(pitch) / 10.0f; }
+    [[nodiscard]] float actualRoll() const { return static_cast<float>(roll) / 10.0f; }
+    [[nodiscard]] float actualYawVelocity() const { return static_cast<float>(yawVelocity) / 10.0f; }
+    [[nodiscard]] float actualPitchVelocity() const { return static_cast<float>(pitchVelocity) / 10.0f; }
+    [[nodiscard]] float actualRollVelocity() const { return static_cast<float>(rollVelocity) / 10.0f; }
+
+    int16_t yaw{0};
+    int16_t pitch{0};
+    int16_t roll{0};
+    int16_t yawVelocity{0};
+    int16_t pitchVelocity{0};
+    int16_t rollVelocity{0};
+
+    static constexpr siyi::Command kCommand = siyi::Command::ACQUIRE_GIMBAL_ATT;
+    using Layout = siyi::FieldLayout<siyi::Field<&GimbalAttitudeMessage::yaw, 0>,
+                                     siyi::Field<&GimbalAttitudeMessage::pitch, 2>,
+                                     siyi::Field<&GimbalAttitudeMessage::roll, 4>,
+                                     siyi::OptionalField<&GimbalAttitudeMessage::yawVelocity, 6>,
+                                     siyi::OptionalField<&GimbalAttitudeMessage::pitchVelocity, 8>,
+                                     siyi::OptionalField<&GimbalAttitudeMessage::rollVelocity, 10>>;
+};
+
+/**
+ * The GimbalControlAngleMessage
+ */
+struct GimbalControlAngleMessage {
+    [[nodiscard]] float actualYaw() const { return static_cast<float>(yaw) / 10.0f; }
+    [[nodiscard]] float actualPitch() const { return static_cast<float>(pitch) / 10.0f; }
+    [[nodiscard]] float actualRoll() const { return static_cast<float>(roll) / 10.0f; }
+
+    int16_t yaw{0};
+    int16_t pitch{0};
+    int16_t roll{0};
+
+    static constexpr siyi::Command kCommand = siyi::Command::GIMBAL_CONTROL_ANGLE;
+    using Layout = siyi::FieldLayout<siyi::Field<&GimbalControlAngleMessage::yaw, 0>,
+                                     siyi::Field<&GimbalControlAngleMessage::pitch, 2>,
+                                     siyi::Field<&GimbalControlAngleMessage::roll, 4>>;
+};
+
+/**
+ * The DataStreamMessage, acknowledges REQUEST_DATA_STREAM
+ */
+struct DataStreamMessage {
+    uint8_t dataType{0}; // siyi::DataStreamType
+
+    static constexpr siyi::Command kCommand = siyi::Command::REQUEST_DATA_STREAM;
+    using Layout = siyi::FieldLayout<siyi::Field<&DataStreamMessage::dataType, 0>>;
+};
+
+// Camera status information
+struct CameraStatusInfoMessage {
+    enum RecordingStatus {
+        RecordingOn     = 0,
+        RecordingOff    = 1,
+        TFCardSlotEmpty = 2,
+        DataLoss        = 3,
+        Undefined,
+    };
+
+    enum class GimbalMotionMode {
+        Lock   = 0,
+        Follow = 1,
+        FPV    = 2,
+        Undefined,
+    };
+
+    enum class GimbalMounting {
+        Reserved   = 0,
+        Normal     = 1,
+        UpsideDown = 2,
+        Undefined,
+    };
+
+    bool             hdrOn{false};
+    RecordingStatus  recordingStatus{RecordingStatus::Undefined};
+    GimbalMotionMode gimbalMotionMode{GimbalMotionMode::Undefined};
+    GimbalMounting   gimbalMounting{GimbalMounting::Undefined};
+    bool             hdmiOnCvbsOff{false};
+
+    static constexpr siyi::Command kCommand = siyi::Command::ACQUIRE_GIMBAL_INFO;
+    using Layout = siyi::FieldLayout<siyi::Field<&CameraStatusInfoMessage::hdrOn, 1, uint8_t>,
+                                     siyi::Field<&CameraStatusInfoMessage::recordingStatus, 3, uint8_t>,
+                                     siyi::Field<&CameraStatusInfoMessage::gimbalMotionMode, 4, uint8_t>,
+                                     siyi::Field<&CameraStatusInfoMessage::gimbalMounting, 5, uint8_t>,
+                                     siyi::Field<&CameraStatusInfoMessage::hdmiOnCvbsOff, 6, siyi::InvertedFlag>>;
+};
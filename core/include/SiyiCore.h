@@ -0,0 +1,15 @@
+#pragma once
+
+// Dependency-free protocol core: no Qt, no heap allocations, no exceptions
+
+#include "CaptureFormat.h"
+#include "Codec.h"
+#include "Command.h"
+#include "Crc16.h"
+#include "Encoder.h"
+#include "FieldLayout.h"
+#include "Frame.h"
+#include "FrameTemplate.h"
+#include "MessageDispatch.h"
+#include "Messages.h"
+#include "StreamFramer.h"
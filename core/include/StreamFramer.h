@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Codec.h"
+#include "Frame.h"
+
+namespace siyi {
+
+/**
+ * Incremental framer for byte streams (TCP, UART) where frames arrive split or concatenated.
+ * It scans for STX, buffers partial frames, validates length and CRC and resynchronizes one byte after
+ * the start of a corrupt frame. Frames that lie completely inside a fed chunk are emitted without copying.
+ * Only frames split across chunks are assembled in an internal buffer.
+ */
+class StreamFramer {
+public:
+    // Longest payload of the protocol, a larger length field is treated as corruption
+    static constexpr size_t kMaxDataLength = FrameBuffer::kMaxPayloadSize;
+    static constexpr size_t kMaxFrameSize  = FrameBuffer::kHeaderSize + kMaxDataLength + FrameBuffer::kCrcSize;
+
+    /**
+     * Resynchronization counters
+     */
+    struct Stats {
+        uint64_t frames{0};
+        uint64_t skippedBytes{0}; // Bytes outside of valid frames
+        uint64_t crcErrors{0};
+        uint64_t lengthErrors{0}; // Length field above kMaxDataLength
+    };
+
+    /**
+     * Feed received bytes
+     * @param data Received chunk, any size
+     * @param length Chunk length
+     * @param onFrame Called as onFrame(const FrameView&) for every valid frame, the view is only valid during the call
+     */
+    template<typename Callback>
+    void feed(const uint8_t* data, size_t length, Callback&& onFrame);
+
+    /**
+     * Drop buffered partial frame, e.g. after reconnecting
+     */
+    void reset() { _buffered = 0; }
+
+    [[nodiscard]] const Stats& stats() const { return _stats; }
+
+private:
+    /**
+     * Find first possible frame start, a trailing 0x55 counts as one
+     * @return Offset of STX, length if there is none
+     */
+    static size_t findStx(const uint8_t* data, size_t length);
+
+    /**
+     * Size of frame starting at data
+     * @return Frame size, 0 if the header is incomplete, kBadStx if data does not start with STX
+     */
+    static size_t frameSize(const uint8_t* data, size_t length);
+
+    /**
+     * Handle frame candidate of known size
+     * @return Number of bytes consumed: the frame size if valid, 1 to resynchronize otherwise
+     */
+    template<typename Callback>
+    size_t consume(const uint8_t* data, size_t size, Callback& onFrame);
+
+    static constexpr size_t  kBadStx  = SIZE_MAX;
+    static constexpr uint8_t kStxLow  = FrameBuffer::kStx & 0xFF;
+    static constexpr uint8_t kStxHigh = FrameBuffer::kStx >> 8;
+
+private:
+    std::array<uint8_t, kMaxFrameSize> _buffer{}; // Partial frame split across chunks
+    std::array<uint8_t, kMaxFrameSize> _rescan{}; // Buffered bytes fed again after corruption
+    size_t                             _buffered{0};
+    Stats                              _stats;
+};
+
+inline size_t StreamFramer::findStx(const uint8_t* data, size_t length) {
+    // memchr is vectorized by the C library, candidates are rare outside of frames
+    size_t offset = 0;
+    while (offset < length) {
+        const auto* candidate = static_cast<const uint8_t*>(std::memchr(data + offset, kStxLow, length - offset));
+        if (candidate == nullptr) {
+            return length;
+        }
+        offset = static_cast<size_t>(candidate - data);
+        if (offset + 1 == length || data[offset + 1] == kStxHigh) {
+            return offset;
+        }
+        ++offset;
+    }
+    return length;
+}
+
+inline size_t StreamFramer::frameSize(const uint8_t* data, size_t length) {
+    if (length >= 1 && data[0] != kStxLow) {
+        return kBadStx;
+    }
+    if (length >= 2 && data[1] != kStxHigh) {
+        return kBadStx;
+    }
+    if (length < FrameBuffer::kHeaderSize) {
+        return 0;
+    }
+    const auto dataLength = static_cast<size_t>(data[3] | (data[4] << 8));
+    return FrameBuffer::kHeaderSize + dataLength + FrameBuffer::kCrcSize;
+}
+
+template<typename Callback>
+size_t StreamFramer::consume(const uint8_t* data, size_t size, Callback& onFrame) {
+    if (size > kMaxFrameSize) {
+        if (size != kBadStx) {
+            ++_stats.lengthErrors;
+        }
+        ++_stats.skippedBytes;
+        return 1;
+    }
+    const auto frame = decodeFrame(data, size);
+    if (frame.valid()) {
+        ++_stats.frames;
+        onFrame(frame);
+        return frame.frameSize;
+    }
+    ++_stats.crcErrors;
+    ++_stats.skippedBytes;
+    return 1;
+}
+
+template<typename Callback>
+void StreamFramer::feed(const uint8_t* data, size_t length, Callback&& onFrame) {
+    size_t position = 0;
+
+    // Complete frame started in an earlier chunk
+    while (_buffered > 0) {
+        const auto size   = frameSize(_buffer.data(), _buffered);
+        const auto needed = size == 0 ? FrameBuffer::kHeaderSize : size;
+        if (needed <= kMaxFrameSize && _buffered < needed) {
+            if (position == length) {
+                return;
+            }
+            const auto count = std::min(needed - _buffered, length - position);
+            std::copy_n(data + position, count, _buffer.data() + _buffered);
+            _buffered += count;
+            position += count;
+            continue;
+        }
+
+        // Frame complete or invalid, on failure everything after the first byte is scanned again
+        const auto consumed = consume(_buffer.data(), size, onFrame);
+        const auto rest     = _buffered - consumed;
+        std::copy_n(_buffer.data() + consumed, rest, _rescan.data());
+        _buffered = 0;
+        if (rest > 0) {
+            feed(_rescan.data(), rest, onFrame);
+        }
+    }
+
+    // Frames inside this chunk are decoded in place
+    while (position < length) {
+        const auto start = position + findStx(data + position, length - position);
+        _stats.skippedBytes += start - position;
+        position = start;
+        if (position == length) {
+            break;
+        }
+
+        const auto available = length - position;
+        const auto size      = frameSize(data + position, available);
+        if (size == 0 || (size <= kMaxFrameSize && size > available)) {
+            // Partial frame, keep it for the next chunk
+            std::copy_n(data + position, available, _buffer.data());
+            _buffered = available;
+            break;
+        }
+        position += consume(data + position, size, onFrame);
+    }
+}
+
+} // namespace siyi
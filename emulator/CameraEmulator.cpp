@@ -0,0 +1,356 @@
+#include "CameraEmulator.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Codec.h"
+#include "Messages.h"
+
+namespace siyi::emulator {
+
+namespace {
+constexpr size_t kReceiveBufferSize = 2048;
+
+// Push periods of DataStreamFrequency values
+constexpr std::chrono::nanoseconds kStreamPeriods[] = {
+    std::chrono::nanoseconds(0),
+    std::chrono::milliseconds(500),
+    std::chrono::milliseconds(250),
+    std::chrono::milliseconds(200),
+    std::chrono::milliseconds(100),
+    std::chrono::milliseconds(50),
+    std::chrono::milliseconds(20),
+    std::chrono::milliseconds(10),
+};
+
+// Firmware versions reported by ACQUIRE_FW_VER
+constexpr uint32_t kBoardVersion    = 0x00030202;
+constexpr uint32_t kGimbalVersion   = 0x00030101;
+constexpr uint32_t kZoomVersion     = 0x00010407;
+constexpr size_t   kHardwareIdSize  = 12;
+constexpr uint8_t  kSuccess         = 1;
+constexpr uint8_t  kFeedbackSuccess = 0;
+constexpr uint8_t  kFeedbackHdrOn   = 2;
+constexpr uint8_t  kFeedbackHdrOff  = 3;
+
+uint8_t* putLittleEndian16(uint8_t* out, int value) {
+    const auto raw = static_cast<uint16_t>(static_cast<int16_t>(value));
+    out[0]         = static_cast<uint8_t>(raw & 0xFF);
+    out[1]         = static_cast<uint8_t>(raw >> 8);
+    return out + 2;
+}
+
+uint8_t* putLittleEndian32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return out + 4;
+}
+
+int16_t readInt16(const uint8_t* data) {
+    return static_cast<int16_t>(static_cast<uint16_t>(data[0] | (data[1] << 8)));
+}
+
+// Angles and rates are sent in 0.1 degree units
+int tenths(float value) {
+    return static_cast<int>(std::lround(value * 10.0f));
+}
+} // namespace
+
+CameraEmulator::CameraEmulator(const EmulatorConfig& config)
+    : _config(config)
+    , _random(config.seed) {}
+
+CameraEmulator::~CameraEmulator() {
+    if (_descriptor >= 0) {
+        ::close(_descriptor);
+    }
+}
+
+bool CameraEmulator::open() {
+    _descriptor = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_descriptor < 0) {
+        std::fprintf(stderr, "socket: %s\n", std::strerror(errno));
+        return false;
+    }
+
+    // Deep buffers absorb bursts of the load tests
+    const int bufferSize = 4 * 1024 * 1024;
+    ::setsockopt(_descriptor, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    ::setsockopt(_descriptor, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+
+    sockaddr_in address{};
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port        = htons(_config.port);
+    if (::bind(_descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::fprintf(stderr, "bind port %u: %s\n", _config.port, std::strerror(errno));
+        ::close(_descriptor);
+        _descriptor = -1;
+        return false;
+    }
+
+    socklen_t length = sizeof(address);
+    ::getsockname(_descriptor, reinterpret_cast<sockaddr*>(&address), &length);
+    _config.port = ntohs(address.sin_port);
+    return true;
+}
+
+void CameraEmulator::receive(Clock::time_point now) {
+    uint8_t buffer[kReceiveBufferSize];
+    while (true) {
+        sockaddr_in source{};
+        socklen_t   sourceLength = sizeof(source);
+        const auto  received =
+            ::recvfrom(_descriptor, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&source), &sourceLength);
+        if (received < 0) {
+            return;
+        }
+
+        // One datagram may carry several frames
+        size_t offset = 0;
+        while (offset < static_cast<size_t>(received)) {
+            const auto frame = decodeFrame(buffer + offset, static_cast<size_t>(received) - offset);
+            if (!frame.valid()) {
+                ++_stats.decodeErrors;
+                break;
+            }
+            ++_stats.framesReceived;
+            handleFrame(frame, source, now);
+            offset += frame.frameSize;
+        }
+    }
+}
+
+void CameraEmulator::update(Clock::time_point now) {
+    if (_lastStep) {
+        _model.step(std::chrono::duration<double>(now - *_lastStep).count());
+    }
+    _lastStep = now;
+
+    if (_attitudePeriod.count() > 0 && now >= _nextAttitude) {
+        replyAttitude(Command::ACQUIRE_GIMBAL_ATT, _pushSequence++, _attitudeDestination, now);
+        // Skip missed periods instead of bursting after a stall
+        _nextAttitude = std::max(_nextAttitude + _attitudePeriod, now);
+    }
+
+    while (!_delayed.empty() && _delayed.top().due <= now) {
+        sendNow(_delayed.top().frame, _delayed.top().destination);
+        _delayed.pop();
+    }
+}
+
+std::optional<CameraEmulator::Clock::time_point> CameraEmulator::nextDeadline() const {
+    std::optional<Clock::time_point> deadline;
+    if (!_delayed.empty()) {
+        deadline = _delayed.top().due;
+    }
+    if (_attitudePeriod.count() > 0) {
+        deadline = deadline ? std::min(*deadline, _nextAttitude) : _nextAttitude;
+    }
+    return deadline;
+}
+
+void CameraEmulator::handleFrame(const FrameView& frame, const sockaddr_in& source, Clock::time_point now) {
+    // Commands act on the state reached at their arrival time
+    update(now);
+
+    const auto  sequenceNumber = _config.echoSequence ? frame.sequenceNumber : uint16_t{0};
+    const auto* data           = frame.data;
+    const auto  length         = frame.dataLength;
+
+    switch (frame.command) {
+    case Command::ACQUIRE_FW_VER: {
+        uint8_t  payload[12];
+        uint8_t* out = putLittleEndian32(payload, kBoardVersion);
+        out          = putLittleEndian32(out, kGimbalVersion);
+        putLittleEndian32(out, kZoomVersion);
+        reply(frame.command, sequenceNumber, payload, sizeof(payload), source, now);
+        break;
+    }
+    case Command::ACQUIRE_HW_ID: {
+        // Two ASCII hex digits of the model followed by the serial number
+        char payload[kHardwareIdSize + 1];
+        std::snprintf(payload, sizeof(payload), "%02X%010u", _config.modelId & 0xFF, _config.serial % 1000000000u);
+        reply(frame.command, sequenceNumber, reinterpret_cast<const uint8_t*>(payload), kHardwareIdSize, source, now);
+        break;
+    }
+    case Command::AUTO_FOCUS:
+    case Command::MANUAL_FOCUS:
+        replyByte(frame.command, sequenceNumber, kSuccess, source, now);
+        break;
+    case Command::MANUAL_ZOOM: {
+        if (length < 1) {
+            ++_stats.decodeErrors;
+            return;
+        }
+        _model.setZoomDirection(static_cast<int8_t>(data[0]));
+        uint8_t payload[2];
+        putLittleEndian16(payload, tenths(_model.zoom()));
+        reply(frame.command, sequenceNumber, payload, sizeof(payload), source, now);
+        break;
+    }
+    case Command::ABSOLUTE_ZOOM:
+        if (length < 1) {
+            ++_stats.decodeErrors;
+            return;
+        }
+        _model.setZoom(static_cast<float>(data[0]) + (length >= 2 ? static_cast<float>(data[1]) / 10.0f : 0.0f));
+        replyByte(frame.command, sequenceNumber, kSuccess, source, now);
+        break;
+    case Command::GIMBAL_ROTATION:
+        if (length < 2) {
+            ++_stats.decodeErrors;
+            return;
+        }
+        _model.setRates(static_cast<int8_t>(data[0]), static_cast<int8_t>(data[1]));
+        replyByte(frame.command, sequenceNumber, kSuccess, source, now);
+        break;
+    case Command::GIMBAL_CENTER:
+        _model.center();
+        replyByte(frame.command, sequenceNumber, kSuccess, source, now);
+        break;
+    case Command::ACQUIRE_GIMBAL_INFO: {
+        const uint8_t payload[] = {
+            0,
+            static_cast<uint8_t>(_model.hdr() ? 1 : 0),
+            0,
+            static_cast<uint8_t>(_model.recording() ? CameraStatusInfoMessage::RecordingOn : CameraStatusInfoMessage::RecordingOff),
+            static_cast<uint8_t>(_model.motionMode()),
+            static_cast<uint8_t>(CameraStatusInfoMessage::GimbalMounting::Normal),
+            static_cast<uint8_t>(_model.hdmiOutput() ? 0 : 1),
+        };
+        reply(frame.command, sequenceNumber, payload, sizeof(payload), source, now);
+        break;
+    }
+    case Command::PHOTO_VIDEO_HDR:
+        if (length < 1) {
+            ++_stats.decodeErrors;
+            return;
+        }
+        switch (data[0]) {
+        case 0:
+            replyByte(Command::FUNC_FEEDBACK_INFO, sequenceNumber, kFeedbackSuccess, source, now);
+            break;
+        case 1:
+            _model.toggleHdr();
+            replyByte(Command::FUNC_FEEDBACK_INFO, sequenceNumber, _model.hdr() ? kFeedbackHdrOn : kFeedbackHdrOff, source, now);
+            break;
+        case 2:
+            _model.toggleRecording();
+            break;
+        case 3:
+            _model.setMotionMode(GimbalModel::MotionMode::Lock);
+            break;
+        case 4:
+            _model.setMotionMode(GimbalModel::MotionMode::Follow);
+            break;
+        case 5:
+            _model.setMotionMode(GimbalModel::MotionMode::FPV);
+            break;
+        case 6:
+            _model.setHdmiOutput(true);
+            break;
+        case 7:
+            _model.setHdmiOutput(false);
+            break;
+        default:
+            break;
+        }
+        break;
+    case Command::ACQUIRE_GIMBAL_ATT:
+        replyAttitude(frame.command, sequenceNumber, source, now);
+        break;
+    case Command::GIMBAL_CONTROL_ANGLE: {
+        if (length < 4) {
+            ++_stats.decodeErrors;
+            return;
+        }
+        _model.setTargetAngles(static_cast<float>(readInt16(data)) / 10.0f, static_cast<float>(readInt16(data + 2)) / 10.0f);
+        uint8_t  payload[6];
+        uint8_t* out = putLittleEndian16(payload, tenths(_model.yaw()));
+        out          = putLittleEndian16(out, tenths(_model.pitch()));
+        putLittleEndian16(out, tenths(_model.roll()));
+        reply(frame.command, sequenceNumber, payload, sizeof(payload), source, now);
+        break;
+    }
+    case Command::REQUEST_DATA_STREAM: {
+        if (length < 2) {
+            ++_stats.decodeErrors;
+            return;
+        }
+        const auto frequency = std::min<size_t>(data[1], std::size(kStreamPeriods) - 1);
+        if (data[0] == static_cast<uint8_t>(DataStreamType::Attitude)) {
+            _attitudePeriod      = kStreamPeriods[frequency];
+            _attitudeDestination = source;
+            _nextAttitude        = now + _attitudePeriod;
+        }
+        replyByte(frame.command, sequenceNumber, data[0], source, now);
+        break;
+    }
+    default:
+        ++_stats.unknownCommands;
+        break;
+    }
+}
+
+void CameraEmulator::replyAttitude(Command command, uint16_t sequenceNumber, const sockaddr_in& destination, Clock::time_point now) {
+    uint8_t  payload[12];
+    uint8_t* out = putLittleEndian16(payload, tenths(_model.yaw()));
+    out          = putLittleEndian16(out, tenths(_model.pitch()));
+    out          = putLittleEndian16(out, tenths(_model.roll()));
+    out          = putLittleEndian16(out, tenths(_model.yawRate()));
+    out          = putLittleEndian16(out, tenths(_model.pitchRate()));
+    putLittleEndian16(out, tenths(_model.rollRate()));
+    reply(command, sequenceNumber, payload, sizeof(payload), destination, now);
+}
+
+void CameraEmulator::reply(Command command, uint16_t sequenceNumber, const uint8_t* data, size_t dataLength,
+                           const sockaddr_in& destination, Clock::time_point now) {
+    if (_config.lossRate > 0.0 && _probability(_random) < _config.lossRate) {
+        ++_stats.framesDropped;
+        return;
+    }
+
+    FrameBuffer frame;
+    if (!encodeFrame(frame, sequenceNumber, command, data, dataLength)) {
+        return;
+    }
+
+    if (_config.corruptionRate > 0.0 && _probability(_random) < _config.corruptionRate) {
+        std::uniform_int_distribution<size_t> bit(0, frame.size() * 8 - 1);
+        const auto                            position = bit(_random);
+        frame.bytes[position / 8] ^= static_cast<uint8_t>(1u << (position % 8));
+        ++_stats.framesCorrupted;
+    }
+
+    auto delay = _config.latency;
+    if (_config.jitter.count() > 0) {
+        std::uniform_int_distribution<int64_t> jitter(-_config.jitter.count(), _config.jitter.count());
+        delay = std::max(std::chrono::microseconds(0), delay + std::chrono::microseconds(jitter(_random)));
+    }
+    if (delay.count() == 0) {
+        sendNow(frame, destination);
+        return;
+    }
+    _delayed.push(Delayed{now + delay, _delayedOrder++, destination, frame});
+}
+
+void CameraEmulator::sendNow(const FrameBuffer& frame, const sockaddr_in& destination) {
+    const auto sent = ::sendto(_descriptor, frame.data(), frame.size(), 0, reinterpret_cast<const sockaddr*>(&destination),
+                               sizeof(destination));
+    if (sent == static_cast<ssize_t>(frame.size())) {
+        ++_stats.framesSent;
+    } else {
+        ++_stats.framesDropped;
+    }
+}
+
+} // namespace siyi::emulator
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <netinet/in.h>
+
+#include "Command.h"
+#include "Frame.h"
+#include "GimbalModel.h"
+
+namespace siyi::emulator {
+
+/**
+ * Link impairments and identity of one emulated camera
+ */
+struct EmulatorConfig {
+    uint16_t                  port{37260};
+    uint16_t                  modelId{0x6B};       // ZR10
+    uint32_t                  serial{1};           // Last digits of the hardware id
+    std::chrono::microseconds latency{0};          // Added to every outgoing frame
+    std::chrono::microseconds jitter{0};           // Uniformly distributed in [-jitter, +jitter], may reorder frames
+    double                    lossRate{0.0};       // Probability an outgoing frame is dropped
+    double                    corruptionRate{0.0}; // Probability one bit of an outgoing frame is flipped
+    uint32_t                  seed{1};
+    bool                      echoSequence{true}; // False replies with sequence number 0, like firmware that does not echo it
+};
+
+/**
+ * UDP endpoint that answers SIYI commands from the simulated gimbal state.
+ * Replies go to the source address of the request and carry its sequence number unless disabled. Not thread-safe,
+ * the owner drives it from one loop through receive() and update().
+ */
+class CameraEmulator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t framesReceived{0};
+        uint64_t framesSent{0};
+        uint64_t framesDropped{0};   // Loss
+        uint64_t framesCorrupted{0}; // Corruption
+        uint64_t decodeErrors{0};
+        uint64_t unknownCommands{0};
+    };
+
+    explicit CameraEmulator(const EmulatorConfig& config);
+    ~CameraEmulator();
+
+    CameraEmulator(const CameraEmulator&)            = delete;
+    CameraEmulator& operator=(const CameraEmulator&) = delete;
+
+    /**
+     * @brief Bind non-blocking UDP socket on all interfaces
+     * @return False if the port cannot be bound
+     */
+    bool open();
+
+    [[nodiscard]] int      descriptor() const { return _descriptor; }
+    [[nodiscard]] uint16_t port() const { return _config.port; } // Bound port, resolved after open() when configured as 0
+
+    /**
+     * @brief Read and answer every datagram waiting on the socket
+     * @param now Current time
+     */
+    void receive(Clock::time_point now);
+
+    /**
+     * @brief Advance gimbal model, push streams and send delayed frames that are due
+     * @param now Current time
+     */
+    void update(Clock::time_point now);
+
+    /**
+     * @return Time at which update() has work to do, empty if nothing is scheduled
+     */
+    [[nodiscard]] std::optional<Clock::time_point> nextDeadline() const;
+
+    [[nodiscard]] const Stats&       stats() const { return _stats; }
+    [[nodiscard]] const GimbalModel& model() const { return _model; }
+
+private:
+    struct Delayed {
+        Clock::time_point due;
+        uint64_t          order; // Keeps equal deadlines in send order
+        sockaddr_in       destination;
+        FrameBuffer       frame;
+
+        bool operator>(const Delayed& other) const { return due != other.due ? due > other.due : order > other.order; }
+    };
+
+    void handleFrame(const FrameView& frame, const sockaddr_in& source, Clock::time_point now);
+
+    /**
+     * Encode frame and send it through the impairment stage
+     */
+    void reply(Command command, uint16_t sequenceNumber, const uint8_t* data, size_t dataLength, const sockaddr_in& destination,
+               Clock::time_point now);
+
+    void replyByte(Command command, uint16_t sequenceNumber, uint8_t value, const sockaddr_in& destination, Clock::time_point now) {
+        reply(command, sequenceNumber, &value, sizeof(value), destination, now);
+    }
+
+    void replyAttitude(Command command, uint16_t sequenceNumber, const sockaddr_in& destination, Clock::time_point now);
+
+    void sendNow(const FrameBuffer& frame, const sockaddr_in& destination);
+
+private:
+    EmulatorConfig _config;
+    int            _descriptor{-1};
+    GimbalModel    _model;
+    Stats          _stats;
+
+    std::mt19937                           _random;
+    std::uniform_real_distribution<double> _probability{0.0, 1.0};
+
+    std::priority_queue<Delayed, std::vector<Delayed>, std::greater<>> _delayed;
+    uint64_t                                                           _delayedOrder{0};
+
+    std::optional<Clock::time_point> _lastStep;
+
+    // Attitude push stream
+    std::chrono::nanoseconds _attitudePeriod{0}; // 0 when off
+    Clock::time_point        _nextAttitude{};
+    sockaddr_in              _attitudeDestination{};
+    uint16_t                 _pushSequence{0};
+};
+
+} // namespace siyi::emulator
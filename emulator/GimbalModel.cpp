@@ -0,0 +1,55 @@
+#include "GimbalModel.h"
+
+#include <algorithm>
+
+namespace siyi::emulator {
+
+void GimbalModel::step(double seconds) {
+    // Fixed sub-steps keep the angle controller stable when the model is idle for a long time
+    while (seconds > 0.0) {
+        const auto dt = std::min(seconds, kMaxStep);
+        integrate(static_cast<float>(dt));
+        seconds -= dt;
+    }
+}
+
+void GimbalModel::integrate(float dt) {
+    if (_angleMode) {
+        _yawRate   = std::clamp((_targetYaw - _yaw) * kAngleGain, -kMaxRate, kMaxRate);
+        _pitchRate = std::clamp((_targetPitch - _pitch) * kAngleGain, -kMaxRate, kMaxRate);
+    } else {
+        _yawRate   = _commandedYawRate;
+        _pitchRate = _commandedPitchRate;
+    }
+
+    const auto yaw   = std::clamp(_yaw + _yawRate * dt, kMinYaw, kMaxYaw);
+    const auto pitch = std::clamp(_pitch + _pitchRate * dt, kMinPitch, kMaxPitch);
+
+    // Report the rate actually achieved, it drops to zero at the mechanical limits
+    _yawRate   = (yaw - _yaw) / dt;
+    _pitchRate = (pitch - _pitch) / dt;
+    _yaw       = yaw;
+    _pitch     = pitch;
+
+    if (_zoomDirection != 0) {
+        setZoom(_zoom + static_cast<float>(_zoomDirection) * kZoomRate * dt);
+    }
+}
+
+void GimbalModel::setRates(int8_t yawSpeed, int8_t pitchSpeed) {
+    _angleMode          = false;
+    _commandedYawRate   = static_cast<float>(std::clamp<int8_t>(yawSpeed, -100, 100)) * kMaxRate / 100.0f;
+    _commandedPitchRate = static_cast<float>(std::clamp<int8_t>(pitchSpeed, -100, 100)) * kMaxRate / 100.0f;
+}
+
+void GimbalModel::setTargetAngles(float yaw, float pitch) {
+    _angleMode   = true;
+    _targetYaw   = std::clamp(yaw, kMinYaw, kMaxYaw);
+    _targetPitch = std::clamp(pitch, kMinPitch, kMaxPitch);
+}
+
+void GimbalModel::setZoom(float level) {
+    _zoom = std::clamp(level, kMinZoom, kMaxZoom);
+}
+
+} // namespace siyi::emulator
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+
+namespace siyi::emulator {
+
+/**
+ * Simulated gimbal and camera state.
+ * Rate commands drive the gimbal until an angle command arrives, angle commands slew towards the target
+ * at the maximum rate. Zoom moves continuously while a manual zoom direction is set.
+ */
+class GimbalModel {
+public:
+    static constexpr float kMaxRate   = 90.0f; // deg/s at speed 100
+    static constexpr float kAngleGain = 5.0f;  // 1/s, proportional gain of the angle controller
+    static constexpr float kMinYaw    = -135.0f;
+    static constexpr float kMaxYaw    = 135.0f;
+    static constexpr float kMinPitch  = -90.0f;
+    static constexpr float kMaxPitch  = 25.0f;
+    static constexpr float kMinZoom   = 1.0f;
+    static constexpr float kMaxZoom   = 30.0f;
+    static constexpr float kZoomRate  = 6.0f; // Zoom factor per second
+
+    static constexpr double kMaxStep = 0.001; // Integration step in seconds
+
+    enum class MotionMode : uint8_t {
+        Lock   = 0,
+        Follow = 1,
+        FPV    = 2,
+    };
+
+    /**
+     * @brief Advance simulation
+     * @param seconds Elapsed time
+     */
+    void step(double seconds);
+
+    /**
+     * @brief Rotate with constant speed
+     * @param yawSpeed Yaw speed [-100, 100]
+     * @param pitchSpeed Pitch speed [-100, 100]
+     */
+    void setRates(int8_t yawSpeed, int8_t pitchSpeed);
+
+    /**
+     * @brief Move to angles
+     * @param yaw Yaw angle in degrees
+     * @param pitch Pitch angle in degrees
+     */
+    void setTargetAngles(float yaw, float pitch);
+
+    void center() { setTargetAngles(0.0f, 0.0f); }
+
+    /**
+     * @brief Start or stop zooming
+     * @param direction 1 zoom in, -1 zoom out, 0 stop
+     */
+    void setZoomDirection(int8_t direction) { _zoomDirection = direction; }
+
+    /**
+     * @brief Jump to zoom level
+     * @param level Zoom factor, clamped to the supported range
+     */
+    void setZoom(float level);
+
+    void toggleRecording() { _recording = !_recording; }
+    void toggleHdr() { _hdr = !_hdr; }
+    void setMotionMode(MotionMode mode) { _motionMode = mode; }
+    void setHdmiOutput(bool hdmi) { _hdmiOutput = hdmi; }
+
+    [[nodiscard]] float      yaw() const { return _yaw; }
+    [[nodiscard]] float      pitch() const { return _pitch; }
+    [[nodiscard]] float      roll() const { return _roll; }
+    [[nodiscard]] float      yawRate() const { return _yawRate; }
+    [[nodiscard]] float      pitchRate() const { return _pitchRate; }
+    [[nodiscard]] float      rollRate() const { return 0.0f; }
+    [[nodiscard]] float      zoom() const { return _zoom; }
+    [[nodiscard]] bool       recording() const { return _recording; }
+    [[nodiscard]] bool       hdr() const { return _hdr; }
+    [[nodiscard]] MotionMode motionMode() const { return _motionMode; }
+    [[nodiscard]] bool       hdmiOutput() const { return _hdmiOutput; }
+
+private:
+    void integrate(float dt);
+
+private:
+    float      _yaw{0.0f};
+    float      _pitch{0.0f};
+    float      _roll{0.0f};
+    float      _yawRate{0.0f}; // deg/s, output of the last step
+    float      _pitchRate{0.0f};
+    float      _commandedYawRate{0.0f};
+    float      _commandedPitchRate{0.0f};
+    float      _targetYaw{0.0f};
+    float      _targetPitch{0.0f};
+    bool       _angleMode{false}; // Angle target active instead of rate command
+    float      _zoom{kMinZoom};
+    int8_t     _zoomDirection{0};
+    bool       _recording{false};
+    bool       _hdr{false};
+    MotionMode _motionMode{MotionMode::Follow};
+    bool       _hdmiOutput{true};
+};
+
+} // namespace siyi::emulator
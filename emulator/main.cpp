@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <poll.h>
+
+#include "CameraEmulator.h"
+
+using namespace siyi::emulator;
+
+namespace {
+std::atomic<bool> stopRequested{false};
+
+void requestStop(int /*signal*/) {
+    stopRequested.store(true);
+}
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "  --port <port>            First UDP port (default 37260)\n"
+                "  --cameras <count>        Number of cameras on consecutive ports (default 1)\n"
+                "  --model <hex>            Model id reported by ACQUIRE_HW_ID, e.g. 6B (ZR10), 7A (ZT30)\n"
+                "  --latency-ms <ms>        Response latency (default 0)\n"
+                "  --jitter-ms <ms>         Uniform latency jitter (default 0)\n"
+                "  --loss <probability>     Outgoing frame loss in [0, 1] (default 0)\n"
+                "  --corrupt <probability>  Outgoing single bit corruption in [0, 1] (default 0)\n"
+                "  --seed <seed>            Random seed of the impairments (default 1)\n"
+                "  --stats <seconds>        Print frame counters periodically, 0 disables (default 0)\n"
+                "  --no-sequence-echo       Reply with sequence number 0 instead of the request's\n",
+                program);
+}
+
+std::chrono::microseconds milliseconds(const char* value) {
+    return std::chrono::microseconds(static_cast<int64_t>(std::atof(value) * 1000.0));
+}
+
+void printStats(const std::vector<std::unique_ptr<CameraEmulator>>& cameras, const EmulatorConfig& config, double seconds,
+                std::vector<uint64_t>& lastReceived) {
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        const auto& stats = cameras[i]->stats();
+        std::printf("port %u: rx %llu (%.0f/s) tx %llu dropped %llu corrupted %llu decode errors %llu unknown %llu\n",
+                    static_cast<unsigned>(config.port + i),
+                    static_cast<unsigned long long>(stats.framesReceived),
+                    static_cast<double>(stats.framesReceived - lastReceived[i]) / seconds,
+                    static_cast<unsigned long long>(stats.framesSent),
+                    static_cast<unsigned long long>(stats.framesDropped),
+                    static_cast<unsigned long long>(stats.framesCorrupted),
+                    static_cast<unsigned long long>(stats.decodeErrors),
+                    static_cast<unsigned long long>(stats.unknownCommands));
+        lastReceived[i] = stats.framesReceived;
+    }
+    std::fflush(stdout);
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    EmulatorConfig config;
+    int            cameraCount   = 1;
+    double         statsInterval = 0.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+        if (std::strcmp(option, "--help") == 0 || std::strcmp(option, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (std::strcmp(option, "--no-sequence-echo") == 0) {
+            config.echoSequence = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", option);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(option, "--port") == 0) {
+            config.port = static_cast<uint16_t>(std::atoi(value));
+        } else if (std::strcmp(option, "--cameras") == 0) {
+            cameraCount = std::max(1, std::atoi(value));
+        } else if (std::strcmp(option, "--model") == 0) {
+            config.modelId = static_cast<uint16_t>(std::strtoul(value, nullptr, 16));
+        } else if (std::strcmp(option, "--latency-ms") == 0) {
+            config.latency = milliseconds(value);
+        } else if (std::strcmp(option, "--jitter-ms") == 0) {
+            config.jitter = milliseconds(value);
+        } else if (std::strcmp(option, "--loss") == 0) {
+            config.lossRate = std::atof(value);
+        } else if (std::strcmp(option, "--corrupt") == 0) {
+            config.corruptionRate = std::atof(value);
+        } else if (std::strcmp(option, "--seed") == 0) {
+            config.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(option, "--stats") == 0) {
+            statsInterval = std::atof(value);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", option);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::unique_ptr<CameraEmulator>> cameras;
+    std::vector<pollfd>                          descriptors;
+    for (int i = 0; i < cameraCount; ++i) {
+        auto cameraConfig = config;
+        cameraConfig.port = static_cast<uint16_t>(config.port + i);
+        cameraConfig.serial += static_cast<uint32_t>(i);
+        cameraConfig.seed += static_cast<uint32_t>(i);
+        auto camera = std::make_unique<CameraEmulator>(cameraConfig);
+        if (!camera->open()) {
+            return 1;
+        }
+        descriptors.push_back(pollfd{camera->descriptor(), POLLIN, 0});
+        cameras.push_back(std::move(camera));
+    }
+    std::printf("Emulating %d camera(s) on UDP port %u-%u\n", cameraCount, config.port,
+                static_cast<unsigned>(config.port + cameraCount - 1));
+    std::fflush(stdout);
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    using Clock = CameraEmulator::Clock;
+
+    const auto statsPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(statsInterval));
+    auto       nextStats   = Clock::now() + statsPeriod;
+    auto       lastStats   = Clock::now();
+
+    std::vector<uint64_t> lastReceived(cameras.size(), 0);
+
+    while (!stopRequested.load()) {
+        auto now = Clock::now();
+
+        // Sleep until the next scheduled frame, a datagram or at most one second
+        auto deadline = now + std::chrono::seconds(1);
+        for (const auto& camera : cameras) {
+            if (const auto next = camera->nextDeadline()) {
+                deadline = std::min(deadline, *next);
+            }
+        }
+        if (statsInterval > 0) {
+            deadline = std::min(deadline, nextStats);
+        }
+        const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now + std::chrono::microseconds(999));
+        ::poll(descriptors.data(), descriptors.size(), static_cast<int>(std::max<int64_t>(0, timeout.count())));
+
+        now = Clock::now();
+        for (size_t i = 0; i < cameras.size(); ++i) {
+            if ((descriptors[i].revents & POLLIN) != 0) {
+                cameras[i]->receive(now);
+            }
+            cameras[i]->update(now);
+        }
+
+        if (statsInterval > 0 && now >= nextStats) {
+            printStats(cameras, config, std::chrono::duration<double>(now - lastStats).count(), lastReceived);
+            lastStats = now;
+            nextStats += statsPeriod;
+        }
+    }
+
+    printStats(cameras, config, std::chrono::duration<double>(Clock::now() - lastStats).count(), lastReceived);
+    return 0;
+}
@@ -1,4 +1,5 @@
-#include <thread>
+#include <chrono>
+#include <memory>
 
 #include <QCommandLineParser>
 #include <QCoreApplication>
@@ -9,26 +10,6 @@
 int main(int argc, char* argv[]) {
     QCoreApplication app(argc, argv);
 
-    // Initialize Siyi API with default IP and port
-    siyi::CameraApi siyiApi;
-
-    // Check initialization
-    if (!siyiApi.initialized()) {
-        // Check initialization status periodically up to 3 seconds
-        int maxTimeout     = 3;
-        int currentTimeout = 0;
-        while (!siyiApi.initialized() && currentTimeout < maxTimeout) {
-            ++currentTimeout;
-            qDebug() << "Siyi API is not initialized. Waiting for initialization...";
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
-    }
-
-    if (!siyiApi.initialized()) {
-        qDebug() << "Cannot initialize Siyi API";
-        return 1;
-    }
-
     // Initialize command line parser
     QCommandLineParser parser;
     parser.setApplicationDescription("Siyi camera and gimbal controller test application");
@@ -36,9 +17,11 @@ int main(int argc, char* argv[]) {
 
     // Custom options
     parser.addOption({"version", "Show camera and gimbal version"});
+    parser.addOption({"discover", "List cameras answering on 192.168.144.0/24"});
     parser.addOption({"take-picture", "Take a picture to SD card"});
     parser.addOption({"toggle-recording", "Toggle video recording to SD card"});
     parser.addOption({"center-gimbal", "Center the gimbal"});
+    parser.addOption({"no-cache", "Do not start from the cached camera identity"});
     QCommandLineOption zoomOption(QStringList() << "zoom", "Use zoom: <in|out|stop>", "<option>");
     zoomOption.setValueName("in|out|stop");
     parser.addOption(zoomOption);
@@ -46,28 +29,58 @@ int main(int argc, char* argv[]) {
     // Process arguments
     parser.process(app);
 
+    auto cametaTypematcher = [](siyi::CameraApi::CameraType type) {
+        switch (type) {
+        case siyi::CameraApi::CameraType::ZR10:
+            return "ZR10";
+        case siyi::CameraApi::CameraType::A8Mini:
+            return "A8Mini";
+        case siyi::CameraApi::CameraType::A2Mini:
+            return "A2Mini";
+        case siyi::CameraApi::CameraType::ZR30:
+            return "ZR30";
+        case siyi::CameraApi::CameraType::ZT30:
+            return "ZT30";
+        case siyi::CameraApi::CameraType::Unknown:
+        default:
+            return "Unknown";
+        }
+    };
+
+    if (parser.isSet("discover")) {
+        siyi::CameraManager manager(0);
+        const auto          cameras = manager.discover().get();
+        for (const auto& camera : cameras) {
+            const auto firmware = camera.firmware ? QString::number(camera.firmware->gimbalFirmwareVersion) : QStringLiteral("unknown");
+            qDebug() << QStringLiteral("%1:%2 %3, firmware version %4, round trip %5 us")
+                            .arg(camera.address)
+                            .arg(camera.port)
+                            .arg(cametaTypematcher(camera.type))
+                            .arg(firmware)
+                            .arg(std::chrono::duration_cast<std::chrono::microseconds>(camera.roundTripTime).count());
+        }
+        return cameras.empty() ? 1 : 0;
+    }
+
+    // Short-lived processes start from the cached identity, versions are always read from the camera
+    std::shared_ptr<siyi::IdentityCache> identityCache;
+    if (!parser.isSet("no-cache") && !parser.isSet("version")) {
+        identityCache = std::make_shared<siyi::IdentityCache>();
+    }
+
+    // Initialize Siyi API with default IP and port
+    siyi::CameraApi siyiApi("192.168.144.25", 37260, identityCache);
+
+    // Hardware ID, firmware and gimbal info are requested together, the camera answers within one round trip
+    if (!siyiApi.waitForReady(siyi::CameraApi::kDefaultReadyDeadline)) {
+        qDebug() << "Cannot initialize Siyi API";
+        return 1;
+    }
+
     if (parser.isSet("version")) {
-        auto cametaTypematcher = [](siyi::CameraApi::CameraType type) {
-            switch (type) {
-            case siyi::CameraApi::CameraType::ZR10:
-                return "ZR10";
-            case siyi::CameraApi::CameraType::A8Mini:
-                return "A8Mini";
-            case siyi::CameraApi::CameraType::A2Mini:
-                return "A2Mini";
-            case siyi::CameraApi::CameraType::ZR30:
-                return "ZR30";
-            case siyi::CameraApi::CameraType::ZT30:
-                return "ZT30";
-            case siyi::CameraApi::CameraType::Unknown:
-            default:
-                return "Unknown";
-            }
-        };
+        const auto firmware = siyiApi.snapshot<FirmwareMessage>().message;
         qDebug() << QStringLiteral("Board version: %1\nFirmware version: %2\nZoom firmware version: %3\nCamera type: %4")
-                        .arg(siyiApi.firmwareMessage.boardVersion,
-                             siyiApi.firmwareMessage.gimbalFirmwareVersion,
-                             siyiApi.firmwareMessage.zoomFirmwareVersion)
+                        .arg(firmware.boardVersion, firmware.gimbalFirmwareVersion, firmware.zoomFirmwareVersion)
                         .arg(cametaTypematcher(siyiApi.cameraType()));
     } else if (parser.isSet("take-picture")) {
         std::ignore = siyiApi.takePhoto();
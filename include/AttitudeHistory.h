@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "Message.h"
+
+namespace siyi {
+
+/**
+ * Unit quaternion, rotation from the gimbal base to the camera
+ */
+struct Quaternion {
+    float w{1.0f};
+    float x{0.0f};
+    float y{0.0f};
+    float z{0.0f};
+};
+
+/**
+ * Gimbal orientation at a point in time
+ */
+struct GimbalPose {
+    enum class Source : uint8_t {
+        None,         // No sample covers the time: history empty, time before the oldest sample or past the horizon
+        Interpolated, // Spherical interpolation between the samples around the time
+        Extrapolated, // Latest sample advanced by its angular velocity
+    };
+
+    [[nodiscard]] bool valid() const { return source != Source::None; }
+
+    std::chrono::steady_clock::time_point time;
+    Quaternion                            orientation;
+    float                                 yaw{0.0f};   // Degrees, derived from orientation
+    float                                 pitch{0.0f}; // Degrees
+    float                                 roll{0.0f};  // Degrees
+    Source                                source{Source::None};
+};
+
+/**
+ * Fixed-capacity ring of timestamped attitude samples, written by the communication thread and queried from
+ * any thread. Samples are stored as a structure of arrays so a query touches only the timestamps it searches
+ * and the two samples it blends. Readers are lock-free: they copy what they need and retry if the writer
+ * replaced samples meanwhile.
+ */
+class AttitudeHistory {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t                    kCapacity{512}; // About 5 s of attitude at 100 Hz
+    static constexpr std::chrono::milliseconds kDefaultHorizon{100};
+
+    /**
+     * @brief Append sample, must only be called from one thread
+     * @param time Receive time of the sample
+     * @param message Attitude with angular velocity
+     */
+    void add(Clock::time_point time, const GimbalAttitudeMessage& message);
+
+    /**
+     * @brief Orientation at time, any thread
+     * @param time Query time, usually the capture time of a video frame
+     * @param horizon Maximal extrapolation past the latest sample
+     * @return Pose, GimbalPose::valid() is false if no sample covers the time
+     */
+    [[nodiscard]] GimbalPose poseAt(Clock::time_point time, std::chrono::nanoseconds horizon = kDefaultHorizon) const;
+
+    /**
+     * @brief Orientation at many times from one consistent view of the history, any thread.
+     * Ascending times are resolved with a single forward scan.
+     * @param times Query times
+     * @param count Number of times
+     * @param poses Output, count entries
+     * @param horizon Maximal extrapolation past the latest sample
+     */
+    void posesAt(const Clock::time_point* times, size_t count, GimbalPose* poses, std::chrono::nanoseconds horizon = kDefaultHorizon) const;
+
+    /**
+     * @return Number of samples held, at most kCapacity
+     */
+    [[nodiscard]] size_t size() const;
+
+private:
+    /**
+     * Resolve one time against samples [first, last) of a consistent read
+     * @param hint Index to start the search from, updated to the sample at or before time
+     */
+    GimbalPose resolve(Clock::time_point time, uint64_t first, uint64_t last, uint64_t& hint, std::chrono::nanoseconds horizon) const;
+
+    static size_t slot(uint64_t index) { return static_cast<size_t>(index % kCapacity); }
+
+private:
+    template<typename T>
+    using Column = std::array<std::atomic<T>, kCapacity>;
+
+    // Odd while the writer replaces a sample
+    std::atomic<uint64_t> _version{0};
+    std::atomic<uint64_t> _count{0}; // Samples ever added, the latest is at _count - 1
+
+    Column<int64_t> _time;      // Nanoseconds of Clock
+    Column<float>   _qw;        // Orientation
+    Column<float>   _qx;
+    Column<float>   _qy;
+    Column<float>   _qz;
+    Column<float>   _yaw;       // Degrees
+    Column<float>   _pitch;
+    Column<float>   _roll;
+    Column<float>   _yawRate;   // Degrees per second
+    Column<float>   _pitchRate;
+    Column<float>   _rollRate;
+};
+
+} // namespace siyi
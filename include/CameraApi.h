@@ -1,18 +1,34 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <optional>
 #include <QObject>
-#include <QThread>
 #include <QTimerEvent>
 
+#include "AttitudeHistory.h"
+#include "Frame.h"
+#include "IdentityCache.h"
+#include "LinkStats.h"
 #include "Message.h"
+#include "MessageHandler.h"
+#include "RealtimeSender.h"
+#include "Request.h"
+#include "Snapshot.h"
 
 namespace siyi {
 
+class CameraManager;
+class CommandCoalescer;
 class CommunicationWorker;
+class LinkMetrics;
 class MessageBuilder;
 
-class CameraApi : public QObject {
+class CameraApi
+    : public QObject
+    , private MessageHandler {
     Q_OBJECT
 
 public:
@@ -25,22 +41,64 @@ public:
         Unknown,
     };
 
-    FirmwareMessage         firmwareMessage;
-    HardwareIDMessage       hardwareIDMessage;
-    ManualZoomMessage       manualZoomMessage;
-    GimbalAttitudeMessage   gimbalAttitudeMessage;
-    ManualFocusMessage      manualFocusMessage;
-    CameraStatusInfoMessage cameraStatusInfoMessage;
+    static constexpr std::chrono::milliseconds kDefaultReadyDeadline{3000};
 
 public:
+    /**
+     * @brief Standalone camera with its own communication thread.
+     * Use CameraManager to run several cameras on one thread and socket.
+     */
     explicit CameraApi(const QString& serverIp = "192.168.144.25", quint16 port = 37260, QObject* parent = nullptr);
+
+    /**
+     * @brief Standalone camera that starts from its cached identity if there is one
+     * @param identityCache Cache shared with other cameras and processes, may be nullptr
+     */
+    CameraApi(const QString& serverIp, quint16 port, std::shared_ptr<IdentityCache> identityCache, QObject* parent = nullptr);
     ~CameraApi() override;
 
     /**
      * @brief Check if Siyi API is initialized
      * @return True if Siyi API is initialized, false otherwise
      */
-    [[nodiscard]] bool initialized() const { return _cameraType != CameraType::Unknown || !hardwareIDMessage.hardwareID.isEmpty(); }
+    [[nodiscard]] bool initialized() const { return cameraType() != CameraType::Unknown || snapshot<HardwareIDMessage>().valid(); }
+
+    /**
+     * @brief Check if the startup handshake completed. The hardware ID, firmware and gimbal info requests are sent
+     * back to back when the camera is created, and retransmitted until their replies arrive or the deadline passes.
+     * With an identity cache entry the camera is ready at once, the handshake then verifies the entry.
+     * @return True once all three replies were received or the identity was loaded from the cache
+     */
+    [[nodiscard]] bool isReady() const { return _ready.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Block until the startup handshake ends, for applications without an event loop
+     * @param timeout Maximal wait
+     * @return True if the camera is ready, false if the handshake or the wait timed out
+     */
+    bool waitForReady(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Change the startup handshake deadline, counted from the creation of the camera.
+     * It is checked whenever a handshake request attempt times out, so a change takes effect within one attempt.
+     * @param deadline Time after which readyTimedOut() is emitted if replies are missing
+     */
+    void setReadyDeadline(std::chrono::milliseconds deadline);
+
+    /**
+     * @brief Latest received message of type T, safe to call from any thread
+     * @return Consistent copy with kernel receive timestamp and sequence, Snapshot::valid() is false if nothing was received yet
+     */
+    template<typename T>
+    [[nodiscard]] Snapshot<T> snapshot() const {
+        return _snapshots.read<T>();
+    }
+
+    /**
+     * @brief Timestamped attitude samples of the last seconds, safe to query from any thread.
+     * Use AttitudeHistory::poseAt() to look up the gimbal orientation at the capture time of a video frame.
+     */
+    [[nodiscard]] const AttitudeHistory& attitudeHistory() const { return _attitudeHistory; }
 
     /**
      * @brief Set gimbal angles
@@ -64,6 +122,37 @@ public:
      */
     [[nodiscard]] bool setRates(float panRate, float tiltRate);
 
+    /**
+     * @brief Create a wait-free, allocation-free sender for a real-time thread. It bypasses the event loop
+     * and the rate limit of setAngles() and setRates().
+     * @return Sender for the calling thread, must not outlive the CameraManager of this camera. Invalid on TCP and
+     * serial transports.
+     */
+    [[nodiscard]] std::unique_ptr<RealtimeSender> createRealtimeSender();
+
+    /**
+     * @brief Limit the send rate of setAngles() and setRates(). Calls in between replace the waiting
+     * value instead of queueing it.
+     * @param rateHz Maximum frames per second and command, 0 sends every value as soon as possible
+     */
+    void setMaxControlRate(double rateHz);
+
+    /**
+     * @brief Limit all frames sent to this camera to what its gimbal MCU can process, 400 per second by default.
+     * Frames above the rate wait by priority: gimbal control first, then user actions, then polls, each class in
+     * call order. Frames still waiting past the deadline of their class are dropped, see LinkStats::outbound.
+     * Frames of a RealtimeSender bypass the limit.
+     * @param rateHz Maximum frames per second, 0 or less disables the limit
+     */
+    void setMaxFrameRate(double rateHz);
+
+    /**
+     * @brief Match acknowledges by command when their sequence number matches no request. Only for firmware that
+     * does not echo request sequence numbers: an unrelated reply to the same command then completes the oldest request.
+     * @param enabled Off by default
+     */
+    void setSequenceFallback(bool enabled);
+
     /**
      * @brief Send take photo message
      * @return True if message was sent, false otherwise
@@ -82,6 +171,22 @@ public:
      */
     [[nodiscard]] bool setCameraMode(uint8_t mode);
 
+    /**
+     * @brief Ask the gimbal to push attitude at a fixed rate instead of polling it.
+     * Polling continues until the gimbal acknowledges, and stays on if it never does. A gimbal that acknowledged a
+     * stream before, see capabilities(), stops being polled right away. When pushes stop for
+     * several stream periods, polling resumes and the stream is requested again.
+     * @param frequency Push rate, DataStreamFrequency::Off returns to polling
+     * @return True if message was sent, false otherwise
+     */
+    bool subscribeGimbalAttitude(DataStreamFrequency frequency);
+
+    /**
+     * @brief Check if the gimbal pushes attitude on its own
+     * @return True if the attitude stream was acknowledged, false if attitude is polled
+     */
+    [[nodiscard]] bool gimbalAttitudeStreaming() const { return _attitudeStreaming.load(std::memory_order_relaxed); }
+
     // Zoom messages
     bool zoom(uint8_t zoomValue);
     bool zoomDirection(int8_t direction);
@@ -89,8 +194,56 @@ public:
     // Focus message
     bool manualFocus(int8_t direction);
 
+    /**
+     * @brief Acknowledged variants of the commands above. The request is retransmitted until it is acknowledged
+     * or the deadline of the last attempt passes.
+     * @param callback Optional completion callback, invoked on the communication thread
+     * @param options Deadline and retries
+     * @return Future with the acknowledge payload and round-trip time
+     */
+    std::future<RequestResult> setAnglesAsync(float pan, float tilt, RequestCallback callback = {}, const RequestOptions& options = {});
+    std::future<RequestResult> setGimbalCenterAsync(RequestCallback callback = {}, const RequestOptions& options = {});
+    std::future<RequestResult> setRatesAsync(float panRate, float tiltRate, RequestCallback callback = {},
+                                             const RequestOptions& options = {});
+    std::future<RequestResult> takePhotoAsync(RequestCallback callback = {}, const RequestOptions& options = {});
+    std::future<RequestResult> zoomAsync(uint8_t zoomValue, RequestCallback callback = {}, const RequestOptions& options = {});
+    std::future<RequestResult> zoomDirectionAsync(int8_t direction, RequestCallback callback = {}, const RequestOptions& options = {});
+    std::future<RequestResult> manualFocusAsync(int8_t direction, RequestCallback callback = {}, const RequestOptions& options = {});
+
+    /**
+     * @brief Link counters and round-trip latency per command, safe to call from any thread
+     * @return Copy of the current statistics
+     */
+    [[nodiscard]] LinkStats stats() const;
+
+    /**
+     * @brief Features learned from this camera or its identity cache entry
+     * @return CameraCapability flags
+     */
+    [[nodiscard]] uint32_t capabilities() const { return _capabilities.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Camera type of a hardware ID model
+     * @param modelId Model from the hardware ID reply
+     * @return Type, Unknown for models this SDK does not know
+     */
+    [[nodiscard]] static CameraType cameraTypeFromModel(uint16_t modelId);
+
     // Camera type
-    [[nodiscard]] CameraType cameraType() const { return _cameraType; };
+    [[nodiscard]] CameraType cameraType() const { return _cameraType.load(std::memory_order_relaxed); };
+
+    /**
+     * @brief Subscribe to typed messages, callbacks are invoked on the communication thread
+     * @param handler Subscriber, must outlive the subscription
+     */
+    void addMessageHandler(MessageHandler* handler);
+
+    /**
+     * @brief Unsubscribe, no callbacks are invoked once this returns.
+     * Must not be called from a message callback.
+     * @param handler Subscriber
+     */
+    void removeMessageHandler(MessageHandler* handler);
 
 signals:
     /**
@@ -98,26 +251,112 @@ signals:
      */
     void updateGimbalAngles();
 
+    /**
+     * Startup handshake completed, hardware ID, firmware and gimbal info are available
+     */
+    void ready();
+
+    /**
+     * Startup handshake deadline passed before all replies arrived
+     */
+    void readyTimedOut();
+
 protected:
     void timerEvent(QTimerEvent* e) override;
 
 private:
+    friend class CameraManager;
+
+    /**
+     * @brief Camera handle sharing the manager's communication thread
+     */
+    CameraApi(CameraManager& manager, const QString& serverIp, quint16 port, QObject* parent = nullptr);
+
     /**
      * @brief Initialize Siyi API
      * @return True if initialization was successful, false otherwise
      */
     void init(const QString& serverIp = "192.168.144.25", quint16 port = 37260);
 
+    /**
+     * Requests of the startup handshake
+     */
+    enum HandshakeStep : size_t {
+        HandshakeHardwareID,
+        HandshakeFirmware,
+        HandshakeGimbalInfo,
+        HandshakeStepCount,
+    };
+
+    /**
+     * Send handshake request, communication thread
+     */
+    void sendHandshakeRequest(HandshakeStep step);
+
+    /**
+     * Retransmit a request that timed out or whose reply could not be parsed, or give up past the deadline
+     */
+    void onHandshakeResult(HandshakeStep step, const RequestResult& result);
+
+    /**
+     * Mark reply received, completes the handshake with the last one
+     */
+    void handshakeReceived(HandshakeStep step);
+
+    /**
+     * Publish handshake outcome and emit ready() or readyTimedOut(), a late success follows a timeout
+     */
+    void finishHandshake(bool success);
+
+    /**
+     * Set readiness, the first call completes waitForReady(), communication thread
+     */
+    void resolveReady(bool success);
+
+    /**
+     * Publish cached identity as if it was received and mark the camera ready, communication thread
+     */
+    void applyCachedIdentity(const CameraIdentity& identity);
+
+    /**
+     * Write received identity to the cache unless it matches the cached entry, communication thread
+     */
+    void storeIdentity();
+
     // Additional message handlers that need to be called after hardware ID message parsing
-    void getCameraType();
+    void getCameraType(const HardwareIDMessage& message);
+
+    // Message handlers, invoked on the communication thread
+    void onFirmware(const FirmwareMessage& message) override;
+    void onHardwareID(const HardwareIDMessage& message) override;
+    void onAutoFocus(const AutoFocusMessage& message) override;
+    void onManualZoom(const ManualZoomMessage& message) override;
+    void onAbsoluteZoom(const AbsoluteZoomMessage& message) override;
+    void onManualFocus(const ManualFocusMessage& message) override;
+    void onGimbalRotation(const GimbalRotationMessage& message) override;
+    void onGimbalCenter(const GimbalCenterMessage& message) override;
+    void onFunctionFeedback(const FunctionFeedbackMessage& message) override;
+    void onGimbalAttitude(const GimbalAttitudeMessage& message) override;
+    void onGimbalControlAngle(const GimbalControlAngleMessage& message) override;
+    void onCameraStatusInfo(const CameraStatusInfoMessage& message) override;
+    void onDataStream(const DataStreamMessage& message) override;
 
-private slots:
     /**
-     * @brief Process SDK message
-     * @param message Message
-     * @param command Command
+     * Send message and track its acknowledge on the communication thread
+     * @param message Encoded request
+     * @param responseCommand Command of the expected acknowledge
+     * @return Future completed together with callback
      */
-    void processSdkMessage(const QVariant& message, quint8 command);
+    std::future<RequestResult> sendRequest(const QByteArray& message, Command responseCommand, RequestCallback callback,
+                                           const RequestOptions& options);
+
+    /**
+     * Publish received message to snapshots with its receive time, call from a message handler only
+     */
+    template<typename T>
+    void publish(const T& message) {
+        _snapshots.publish(message, receiveInfo().receiveTime);
+    }
 
 signals:
     /**
@@ -127,11 +366,40 @@ signals:
     void sendMessage(const QByteArray& message);
 
 private:
-    CommunicationWorker*            _siyiCommunicationWorker{nullptr};
-    QThread                         _siyiCommunicationWorkerThread;
-    std::shared_ptr<MessageBuilder> _messageBuilder{nullptr};
-    int                             _gimbalAttitudeTimer{-1};
-    CameraType                      _cameraType{CameraType::Unknown};
+    std::unique_ptr<CameraManager>     _ownManager; // Set for standalone cameras only
+    CameraManager*                     _manager{nullptr};
+    CommunicationWorker*               _siyiCommunicationWorker{nullptr};
+    int                                _cameraId{-1};
+    std::shared_ptr<MessageBuilder>    _messageBuilder{nullptr};
+    std::shared_ptr<const LinkMetrics> _metrics;
+    std::shared_ptr<CommandCoalescer>  _coalescer;
+    int                                _gimbalAttitudeTimer{-1};
+    std::atomic<CameraType>            _cameraType{CameraType::Unknown};
+    SnapshotStore                      _snapshots;
+    AttitudeHistory                    _attitudeHistory; // Written by the communication thread
+
+    // Attitude stream, requested frequency is written on the API thread and read on the communication thread
+    std::atomic<DataStreamFrequency>      _attitudeStreamFrequency{DataStreamFrequency::Off};
+    std::atomic<bool>                     _attitudeStreaming{false};
+    std::chrono::steady_clock::time_point _attitudeStreamRequested{};
+    bool                                  _attitudeStreamPending{false};
+
+    // Startup handshake, state is written on the communication thread
+    std::chrono::steady_clock::time_point _handshakeStarted{};
+    std::chrono::milliseconds             _readyDeadline{kDefaultReadyDeadline};
+    uint8_t                               _handshakeReceived{0}; // Bit per HandshakeStep
+    bool                                  _handshakeFinished{false};
+    bool                                  _readyResolved{false};
+    std::atomic<bool>                     _ready{false};
+    std::promise<bool>                    _readyPromise;
+    std::shared_future<bool>              _readyFuture{_readyPromise.get_future().share()};
+
+    // Identity cache, the entry is verified on the communication thread and written on the cache thread of the manager
+    std::shared_ptr<IdentityCache> _identityCache;
+    QString                        _serverIp;
+    quint16                        _port{0};
+    std::optional<CameraIdentity>  _cachedIdentity;
+    std::atomic<uint32_t>          _capabilities{0};
 };
 
 } // namespace siyi
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <QObject>
+#include <QThread>
+#include <QThreadPool>
+
+#include "CameraApi.h"
+#include "Capture.h"
+#include "Discovery.h"
+#include "TransportConfig.h"
+
+namespace siyi {
+
+class CommunicationWorker;
+
+/**
+ * Runs any number of cameras on one communication thread and one transport.
+ * Received frames are demultiplexed by source address, every camera keeps its own sequence numbers and state.
+ */
+class CameraManager : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @param localPort Local UDP port shared by all cameras, 0 picks any free port
+     * @param parent Parent object
+     */
+    explicit CameraManager(quint16 localPort = 37260, QObject* parent = nullptr);
+
+    /**
+     * @param config UDP, TCP or serial link, TCP and serial links serve one camera
+     * @param parent Parent object
+     */
+    explicit CameraManager(const TransportConfig& config, QObject* parent = nullptr);
+    ~CameraManager() override;
+
+    /**
+     * @brief Add camera
+     * @param serverIp Camera address
+     * @param port Camera port
+     * @return Camera handle owned by the manager
+     */
+    CameraApi* addCamera(const QString& serverIp, quint16 port = 37260);
+
+    /**
+     * @brief Start cameras added afterwards from their cached identity, and keep the cache up to date
+     * Entries are read when a camera is added and written by a background thread.
+     * @param identityCache Cache, nullptr disables caching
+     */
+    void setIdentityCache(std::shared_ptr<IdentityCache> identityCache) { _identityCache = std::move(identityCache); }
+
+    /**
+     * @brief Remove and destroy camera
+     * @param camera Camera handle returned by addCamera()
+     */
+    void removeCamera(CameraApi* camera);
+
+    /**
+     * @brief Cameras added to the manager
+     */
+    [[nodiscard]] std::vector<CameraApi*> cameras() const;
+
+    /**
+     * @brief Record every frame sent and received by the cameras of this manager to a binary capture file.
+     * Frames are written by a background thread. Frames of a RealtimeSender bypass the communication
+     * thread and are not recorded.
+     * @param path Capture file, replaced if it exists
+     * @return True if the file was created
+     */
+    bool startCapture(const QString& path);
+
+    /**
+     * @brief Stop recording, remaining frames are written before this returns
+     * @return Counters of the recording
+     */
+    CaptureStats stopCapture();
+
+    /**
+     * @brief Feed the received frames of a capture through decode, the parsers and the CameraApi handlers
+     * and signals, as if they arrived on the link, stamped with their recorded offset from the start of the replay.
+     * Pending requests and LinkStats are left untouched. Records are delivered to the camera with the recorded id;
+     * ids are assigned in the order cameras are added, so add cameras in the order of the recording manager.
+     * Link traffic is served while replaying.
+     * @param path Capture file
+     * @param speed Keep the recorded timing or replay as fast as possible
+     * @return Future completed when the capture is replayed
+     */
+    std::future<ReplayStats> replayCapture(const QString& path, ReplaySpeed speed = ReplaySpeed::RealTime);
+
+    /**
+     * @brief Find cameras by probing an address range or a broadcast address with hardware ID requests.
+     * All probes are sent at once and replies are collected concurrently, so a /24 takes one round trip plus
+     * the timeout. Cameras that answer are asked for their firmware within the same timeout. Cameras already
+     * added to the manager answer too. Needs a UDP transport.
+     * @param options Addresses and timeout
+     * @return Future completed with the cameras that answered, in reply order
+     */
+    std::future<std::vector<DiscoveredCamera>> discover(const DiscoveryOptions& options = {});
+
+private:
+    friend class CameraApi;
+
+    /**
+     * Run function on the communication thread and wait until it returns
+     * @param function Function to run
+     */
+    void runOnWorkerThread(const std::function<void(CommunicationWorker&)>& function);
+
+    /**
+     * Write the identity cache on the cache thread, writes run one at a time in the order they were queued
+     * @param write Function accessing the cache file
+     */
+    void writeIdentityCache(std::function<void()> write);
+
+private:
+    CommunicationWorker*                    _worker{nullptr};
+    QThread                                 _workerThread;
+    std::vector<std::unique_ptr<CameraApi>> _cameras;
+    std::shared_ptr<IdentityCache>          _identityCache;
+    QThreadPool                             _identityCacheWriter; // Outlives the worker, pending writes finish on destruction
+};
+
+} // namespace siyi
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace siyi {
+
+/**
+ * Counters of a capture recording
+ */
+struct CaptureStats {
+    uint64_t records{0};        // Frames written to the file
+    uint64_t bytes{0};          // File size including headers
+    uint64_t droppedRecords{0}; // Frames lost because the writer fell behind or the file could not be written
+};
+
+/**
+ * Pacing of a capture replay
+ */
+enum class ReplaySpeed : uint8_t {
+    RealTime,         // Keep the recorded gaps between received frames
+    AsFastAsPossible, // Deliver frames back to back, for throughput tests
+};
+
+/**
+ * Outcome of a capture replay
+ */
+struct ReplayStats {
+    [[nodiscard]] bool ok() const { return opened && !truncated; }
+
+    bool                     opened{false};        // File was read and has a valid header
+    bool                     truncated{false};     // File ends inside a record
+    uint64_t                 framesReplayed{0};    // Received frames delivered to parsers
+    uint64_t                 decodeErrors{0};      // Received frames rejected by decode
+    uint64_t                 sentSkipped{0};       // Sent frames, they are not replayed
+    uint64_t                 unknownCamera{0};     // Received frames of a camera id not registered with the manager
+    std::chrono::nanoseconds captureDuration{0};   // Time between the first and last record
+    std::chrono::nanoseconds elapsed{0};           // Wall time of the replay
+};
+
+} // namespace siyi
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include <QString>
+
+#include "CameraApi.h"
+#include "Message.h"
+
+namespace siyi {
+
+/**
+ * Addresses probed by a camera discovery
+ */
+struct DiscoveryOptions {
+    /**
+     * @brief Probe every address of a range
+     * @param first First address
+     * @param last Last address, inclusive
+     * @param port Camera port
+     */
+    static DiscoveryOptions range(const QString& first, const QString& last, quint16 port = 37260) {
+        DiscoveryOptions options;
+        options.firstAddress = first;
+        options.lastAddress  = last;
+        options.port         = port;
+        return options;
+    }
+
+    /**
+     * @brief Probe a directed broadcast address, one probe reaches every camera of the network
+     * @param address Broadcast address
+     * @param port Camera port
+     */
+    static DiscoveryOptions broadcast(const QString& address = "192.168.144.255", quint16 port = 37260) {
+        return range(address, address, port);
+    }
+
+    QString                   firstAddress{"192.168.144.1"};
+    QString                   lastAddress{"192.168.144.254"}; // Inclusive, the default covers the camera /24
+    quint16                   port{37260};
+    std::chrono::milliseconds timeout{500}; // Replies are collected this long after the probes are sent
+};
+
+/**
+ * Camera that answered a discovery probe
+ */
+struct DiscoveredCamera {
+    QString                        address;
+    quint16                        port{0};
+    CameraApi::CameraType          type{CameraApi::CameraType::Unknown};
+    HardwareIDMessage              hardwareID;
+    std::optional<FirmwareMessage> firmware;         // Empty if the firmware reply missed the timeout
+    std::chrono::nanoseconds       roundTripTime{0}; // Hardware ID probe sent to reply received
+};
+
+} // namespace siyi
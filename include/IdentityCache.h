@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include <QString>
+
+#include "Message.h"
+
+namespace siyi {
+
+/**
+ * Features learned from a camera, cached with its identity
+ */
+enum CameraCapability : uint32_t {
+    CapabilityAttitudeStream = 1U << 0, // Gimbal acknowledged an attitude data stream request
+};
+
+/**
+ * Identity, firmware and capabilities of one camera
+ */
+struct CameraIdentity {
+    HardwareIDMessage hardwareID;
+    FirmwareMessage   firmware;
+    uint32_t          capabilities{0}; // CameraCapability flags
+};
+
+/**
+ * On-disk cache of camera identities keyed by camera address, for processes that start often.
+ * A camera created with a cached entry is usable at once; its startup handshake verifies the entry in the
+ * background, replaces it when the firmware or capabilities changed and drops it when the hardware ID differs.
+ * The file is an INI file shared by concurrent processes. Methods may be called from any thread.
+ */
+class IdentityCache {
+public:
+    /**
+     * @param path Cache file, created on the first store
+     */
+    explicit IdentityCache(const QString& path = defaultPath());
+
+    /**
+     * @return Cache file in the cache directory of the user
+     */
+    static QString defaultPath();
+
+    /**
+     * @brief Read entry of camera
+     * @param address Camera address
+     * @param port Camera port
+     * @return Identity, empty if the camera is not cached or the entry is unreadable
+     */
+    [[nodiscard]] std::optional<CameraIdentity> load(const QString& address, quint16 port) const;
+
+    /**
+     * @brief Add or replace entry of camera
+     * @param address Camera address
+     * @param port Camera port
+     * @param identity Verified identity
+     * @return True if the file was written
+     */
+    bool store(const QString& address, quint16 port, const CameraIdentity& identity);
+
+    /**
+     * @brief Drop entry of camera
+     * @param address Camera address
+     * @param port Camera port
+     */
+    void remove(const QString& address, quint16 port);
+
+    [[nodiscard]] const QString& path() const { return _path; }
+
+private:
+    QString _path;
+};
+
+} // namespace siyi
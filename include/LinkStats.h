@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Command.h"
+
+namespace siyi {
+
+/**
+ * Round-trip latency distribution of one command.
+ * Buckets are log-linear: exact below 8 µs, then 8 buckets per power of two (12.5 % resolution) up to about 70 minutes.
+ */
+struct LatencyStats {
+    static constexpr size_t   kSubBucketBits = 3;
+    static constexpr size_t   kSubBuckets    = size_t{1} << kSubBucketBits;
+    static constexpr size_t   kMaxExponent   = 31;
+    static constexpr size_t   kBuckets       = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+    static constexpr uint64_t kMaxValue      = (uint64_t{1} << (kMaxExponent + 1)) - 1;
+
+    /**
+     * @param micros Latency in microseconds, clamped to kMaxValue
+     * @return Bucket holding micros
+     */
+    static constexpr size_t bucketIndex(uint64_t micros) {
+        if (micros > kMaxValue) {
+            micros = kMaxValue;
+        }
+        if (micros < kSubBuckets) {
+            return static_cast<size_t>(micros);
+        }
+        size_t exponent = 0;
+        for (auto value = micros; value > 1; value >>= 1) {
+            ++exponent;
+        }
+        const auto shift = exponent - kSubBucketBits;
+        return (shift + 1) * kSubBuckets + static_cast<size_t>((micros >> shift) & (kSubBuckets - 1));
+    }
+
+    /**
+     * @param index Bucket index
+     * @return Smallest latency in microseconds counted by the bucket
+     */
+    static constexpr uint64_t bucketLowerBound(size_t index) {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        const auto shift = index / kSubBuckets - 1;
+        return (kSubBuckets + index % kSubBuckets) << shift;
+    }
+
+    /**
+     * @param fraction Quantile in [0, 1], e.g. 0.99
+     * @return Lower bound of the bucket holding the quantile, zero if nothing was recorded
+     */
+    [[nodiscard]] std::chrono::microseconds percentile(double fraction) const;
+
+    /**
+     * @return Mean latency, zero if nothing was recorded
+     */
+    [[nodiscard]] std::chrono::microseconds mean() const {
+        return std::chrono::microseconds(count == 0 ? 0 : static_cast<int64_t>(sumMicros / count));
+    }
+
+    Command                        command{Command::UNKNOWN};
+    uint64_t                       count{0};
+    uint64_t                       sumMicros{0};
+    uint64_t                       minMicros{0};
+    uint64_t                       maxMicros{0};
+    std::array<uint64_t, kBuckets> buckets{};
+};
+
+static_assert(LatencyStats::bucketIndex(7) == 7);
+static_assert(LatencyStats::bucketIndex(8) == 8);
+static_assert(LatencyStats::bucketIndex(LatencyStats::kMaxValue) == LatencyStats::kBuckets - 1);
+static_assert(LatencyStats::bucketLowerBound(LatencyStats::bucketIndex(1000)) <= 1000);
+
+/**
+ * Outbound priority class of a frame, lower classes are sent first
+ */
+enum class SendPriority : uint8_t {
+    Control,    // Gimbal motion: rotation, control angle, center
+    Action,     // User actions: photo, recording, zoom, focus, data streams
+    Background, // Polls and identity requests
+};
+
+inline constexpr size_t kSendPriorityCount = 3;
+
+/**
+ * Outbound queue of one priority class
+ */
+struct OutboundQueueStats {
+    uint64_t depth{0};         // Frames waiting for the frame rate limit
+    uint64_t maxDepth{0};      // Highest depth so far
+    uint64_t sent{0};          // Frames that left the queue
+    uint64_t staleDrops{0};    // Frames dropped past their deadline, or polls replaced by an identical newer one
+    uint64_t overflowDrops{0}; // Frames dropped because the queue was full
+};
+
+/**
+ * Link counters of one camera and latency of every command that was answered
+ */
+struct LinkStats {
+    /**
+     * @return Latency of command, nullptr if it was never answered
+     */
+    [[nodiscard]] const LatencyStats* latency(Command command) const {
+        for (const auto& stats : latencies) {
+            if (stats.command == command) {
+                return &stats;
+            }
+        }
+        return nullptr;
+    }
+
+    uint64_t framesSent{0};
+    uint64_t bytesSent{0};
+    uint64_t framesReceived{0};
+    uint64_t bytesReceived{0};
+    uint64_t crcErrors{0};          // CRC mismatch
+    uint64_t lengthErrors{0};       // Truncated frame or payload shorter than the message layout
+    uint64_t framingErrors{0};      // Frame does not start with STX
+    uint64_t unknownCommands{0};    // Valid frame without a parser
+    uint64_t retransmissions{0};    // Acknowledged requests sent again
+    uint64_t requestTimeouts{0};    // Acknowledged requests that ran out of retries
+    uint64_t coalescedUpdates{0};   // Control updates replaced by a newer value before they were sent
+    uint64_t directSendFailures{0}; // RealtimeSender frames rejected by a full socket buffer or an error
+
+    std::array<OutboundQueueStats, kSendPriorityCount> outbound{}; // Indexed by SendPriority
+    std::vector<LatencyStats>                          latencies;  // Commands with at least one answered request
+};
+
+} // namespace siyi
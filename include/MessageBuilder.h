@@ -1,14 +1,30 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
-#include <tuple>
 
 #include <QByteArray>
 
 #include "Command.h"
+#include "Encoder.h"
+#include "Frame.h"
 
 namespace siyi {
 
+/**
+ * Sequence counter shared by threads building frames of the same camera
+ */
+class AtomicSequenceCounter {
+public:
+    uint16_t next() { return _value.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint16_t> _value{0};
+};
+
+/**
+ * Qt adapter over the protocol core Encoder, adds QByteArray frames and logging
+ */
 class MessageBuilder {
 public:
     QByteArray buildFirmwareRequestMessage();
@@ -61,44 +77,64 @@ public:
     QByteArray buildAcquireGimbalInfoRequestMessage();
 
     /**
-     * @brief Decode incoming data
-     * @param message Data to decode
-     * @return Tuple containing decoded data {data, data length, command, sequence number}
+     * Request gimbal to push data at a fixed rate
+     * @param type Data to push
+     * @param frequency Push rate, DataStreamFrequency::Off stops the stream
+     * @return Data stream request message
      */
-    [[nodiscard]] std::tuple<QByteArray, size_t, Command, uint16_t> decode(const QByteArray& message);
+    QByteArray buildDataStreamRequestMessage(DataStreamType type, DataStreamFrequency frequency);
+
+    // Allocation-free variants: the whole frame is written into the caller-owned buffer
+    void buildFirmwareRequestMessage(FrameBuffer& frame);
+    void buildHardwareIDRequestMessage(FrameBuffer& frame);
+    void buildManualZoomRequestMessage(FrameBuffer& frame, int8_t direction);
+    void buildAbsoluteZoomRequestMessage(FrameBuffer& frame, uint8_t zoomLevel);
+    void buildAutoFocusRequestMessage(FrameBuffer& frame);
+    void buildManualFocusShotRequestMessage(FrameBuffer& frame, int8_t direction);
+    void buildGimbalRotationRequestMessage(FrameBuffer& frame, int8_t yawSpeed, int8_t pitchSpeed);
+    void buildGimbalCenterRequestMessage(FrameBuffer& frame);
+    void buildSetGimbalControlAngleRequestMessage(FrameBuffer& frame, int16_t yawAngle, int16_t pitchAngle);
+    void buildAcquireGimbalAttitudeRequestMessage(FrameBuffer& frame);
+    void buildTakePhotoRequestMessage(FrameBuffer& frame);
+    void buildSwitchHDRRequestMessage(FrameBuffer& frame);
+    void buildStartStopRecordingRequestMessage(FrameBuffer& frame);
+    void buildMotionLockModeRequestMessage(FrameBuffer& frame);
+    void buildMotionFollowModeRequestMessage(FrameBuffer& frame);
+    void buildMotionFPVModeRequestMessage(FrameBuffer& frame);
+    void buildSetVideoOutputHDMIRequestMessage(FrameBuffer& frame);
+    void buildSetVideoOutputCVBSRequestMessage(FrameBuffer& frame);
+    void buildAcquireGimbalInfoRequestMessage(FrameBuffer& frame);
+    void buildDataStreamRequestMessage(FrameBuffer& frame, DataStreamType type, DataStreamFrequency frequency);
 
-private:
     /**
-     * @brief Encode outgoing data
+     * @brief Encode outgoing data into a caller-owned buffer without touching the heap
+     * @param frame Destination buffer, frame.size() holds the encoded length afterwards
      * @param command Command to encode
-     * @param data Data to encode
-     * @return Encoded data
+     * @param data Payload, may be nullptr when dataLength is 0
+     * @param dataLength Payload length, must not exceed FrameBuffer::kMaxPayloadSize
+     * @return True if the frame was encoded, false if the payload does not fit
      */
-    [[nodiscard]] QByteArray encode(Command command, const QByteArray& data = {});
+    bool encode(FrameBuffer& frame, Command command, const uint8_t* data = nullptr, size_t dataLength = 0);
 
     /**
-     * Increments sequence number by one.
-     * @return Sequence number
+     * @brief Decode the frame at the start of incoming data without copying it
+     * @param data Received bytes
+     * @param length Number of received bytes
+     * @return View into data, check FrameView::error before use
      */
-    uint16_t getSequenceNumber();
-
-    /**
-     * Reverts bytes in a 16-bit value.
-     * @param value Value to revert
-     * @return Reverted value
-     */
-    uint16_t revertBytes(uint16_t value);
+    [[nodiscard]] static FrameView decode(const uint8_t* data, size_t length);
+    [[nodiscard]] static FrameView decode(const QByteArray& message);
 
+private:
     /**
-     * Extracts byte from QByteArray at specified index.
-     * @param data Data to extract byte from
-     * @param index Index of byte to extract
-     * @return Extracted byte
+     * Copies encoded frame into QByteArray.
+     * @param frame Encoded frame
+     * @return Frame bytes
      */
-    uint8_t extractByte(const QByteArray& data, size_t index);
+    static QByteArray toByteArray(const FrameBuffer& frame);
 
 private:
-    static uint16_t _sequenceNumber;
+    Encoder<AtomicSequenceCounter> _encoder; // Per camera, frames may be built on any thread
 };
 
 } // namespace siyi
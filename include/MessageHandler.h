@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "Message.h"
+
+namespace siyi {
+
+class MessageParser;
+
+/**
+ * Arrival of a received message
+ */
+struct ReceiveInfo {
+    std::chrono::steady_clock::time_point receiveTime;       // Kernel receive timestamp, or read time if the transport has none
+    uint16_t                              sequenceNumber{0}; // Sequence number of the frame
+};
+
+/**
+ * Statically typed subscriber for received messages.
+ * Callbacks are invoked on the communication thread, override only the ones you need.
+ */
+class MessageHandler {
+public:
+    virtual ~MessageHandler() = default;
+
+    virtual void onFirmware(const FirmwareMessage& /*message*/) {}
+    virtual void onHardwareID(const HardwareIDMessage& /*message*/) {}
+    virtual void onAutoFocus(const AutoFocusMessage& /*message*/) {}
+    virtual void onManualZoom(const ManualZoomMessage& /*message*/) {}
+    virtual void onAbsoluteZoom(const AbsoluteZoomMessage& /*message*/) {}
+    virtual void onManualFocus(const ManualFocusMessage& /*message*/) {}
+    virtual void onGimbalRotation(const GimbalRotationMessage& /*message*/) {}
+    virtual void onGimbalCenter(const GimbalCenterMessage& /*message*/) {}
+    virtual void onFunctionFeedback(const FunctionFeedbackMessage& /*message*/) {}
+    virtual void onGimbalAttitude(const GimbalAttitudeMessage& /*message*/) {}
+    virtual void onGimbalControlAngle(const GimbalControlAngleMessage& /*message*/) {}
+    virtual void onCameraStatusInfo(const CameraStatusInfoMessage& /*message*/) {}
+    virtual void onDataStream(const DataStreamMessage& /*message*/) {}
+
+protected:
+    /**
+     * Arrival of the message being dispatched, only valid inside a callback
+     */
+    [[nodiscard]] const ReceiveInfo& receiveInfo() const { return _receiveInfo; }
+
+private:
+    friend class MessageParser;
+
+    ReceiveInfo _receiveInfo; // Set by the parser before every callback
+};
+
+} // namespace siyi
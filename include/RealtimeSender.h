@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Command.h"
+#include "Frame.h"
+
+namespace siyi {
+
+class LinkMetrics;
+class MessageBuilder;
+
+/**
+ * Send path for real-time threads. Frames are encoded on the caller's stack and written with one non-blocking
+ * sendto() on the socket of the communication thread, so a call never allocates, takes a lock or waits for
+ * another thread. A full socket buffer makes the call fail instead of blocking.
+ * One sender per producer thread, it must not outlive the CameraManager of its camera. POSIX and UDP
+ * transports only: on TCP and serial links, and on other platforms, valid() is false and every call fails.
+ */
+class RealtimeSender {
+public:
+    ~RealtimeSender();
+
+    RealtimeSender(const RealtimeSender&)            = delete;
+    RealtimeSender& operator=(const RealtimeSender&) = delete;
+
+    /**
+     * @brief Check if frames can be sent
+     * @return False if the socket is not bound, the transport is not UDP or the camera address is not IPv4
+     */
+    [[nodiscard]] bool valid() const { return _descriptor >= 0 && _ipv4Address != 0; }
+
+    /**
+     * @brief Set gimbal angles
+     * @param pan Pan angle
+     * @param tilt Tilt angle
+     * @return True if the frame was handed to the kernel
+     */
+    bool setAngles(float pan, float tilt);
+
+    /**
+     * @brief Set gimbal rates
+     * @param panRate Pan rate
+     * @param tiltRate Tilt rate
+     * @return True if the frame was handed to the kernel
+     */
+    bool setRates(float panRate, float tiltRate);
+
+    /**
+     * @brief Encode and send any command
+     * @param command Command
+     * @param data Payload, may be nullptr when dataLength is 0
+     * @param dataLength Payload length, must not exceed FrameBuffer::kMaxPayloadSize
+     * @return True if the frame was handed to the kernel
+     */
+    bool send(Command command, const uint8_t* data = nullptr, size_t dataLength = 0);
+
+private:
+    friend class CommunicationWorker;
+
+    RealtimeSender(std::shared_ptr<MessageBuilder> messageBuilder, std::shared_ptr<LinkMetrics> metrics, intptr_t descriptor,
+                   uint32_t ipv4Address, uint16_t port);
+
+    /**
+     * Write encoded frame to the socket without blocking
+     */
+    bool sendFrame(const FrameBuffer& frame);
+
+private:
+    std::shared_ptr<MessageBuilder> _messageBuilder; // Shared with CameraApi, sequence numbers stay per camera
+    std::shared_ptr<LinkMetrics>    _metrics;
+    intptr_t                        _descriptor{-1};
+    uint32_t                        _ipv4Address{0}; // Host byte order
+    uint16_t                        _port{0};
+};
+
+} // namespace siyi
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include <QByteArray>
+
+#include "Command.h"
+
+namespace siyi {
+
+/**
+ * Outcome of an acknowledged request
+ */
+enum class RequestStatus : uint8_t {
+    Acknowledged,
+    TimedOut,
+    Cancelled, // Camera was removed before the request completed
+};
+
+/**
+ * Deadline and retransmissions of one request
+ */
+struct RequestOptions {
+    std::chrono::milliseconds timeout{200}; // Per attempt
+    int                       retries{2};   // Retransmissions after the first attempt
+};
+
+/**
+ * Result of a request, delivered once per request
+ */
+struct RequestResult {
+    [[nodiscard]] bool ok() const { return status == RequestStatus::Acknowledged; }
+
+    RequestStatus            status{RequestStatus::TimedOut};
+    Command                  command{Command::UNKNOWN}; // Command of the acknowledge
+    uint16_t                 sequenceNumber{0};         // Sequence number of the request
+    QByteArray               payload;                   // Acknowledge payload
+    std::chrono::nanoseconds roundTripTime{0};          // From the last transmission to the receive time of the acknowledge
+    int                      attempts{0};               // Number of transmissions
+};
+
+/**
+ * Completion callback, invoked on the communication thread
+ */
+using RequestCallback = std::function<void(const RequestResult& result)>;
+
+} // namespace siyi
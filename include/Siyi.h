@@ -1,6 +1,17 @@
 #pragma once
 
+#include "AttitudeHistory.h"
 #include "CameraApi.h"
-#include "Command.h"
+#include "CameraManager.h"
+#include "Capture.h"
+#include "Discovery.h"
+#include "IdentityCache.h"
+#include "LinkStats.h"
 #include "Message.h"
 #include "MessageBuilder.h"
+#include "MessageHandler.h"
+#include "RealtimeSender.h"
+#include "Request.h"
+#include "SiyiCore.h"
+#include "Snapshot.h"
+#include "TransportConfig.h"
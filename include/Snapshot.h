@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+
+#include "Message.h"
+
+namespace siyi {
+
+/**
+ * Consistent copy of the latest received message
+ */
+template<typename T>
+struct Snapshot {
+    [[nodiscard]] bool valid() const { return sequence != 0; }
+
+    T                                     message;
+    std::chrono::steady_clock::time_point timestamp; // Receive time, see ReceiveInfo::receiveTime
+    uint64_t                              sequence{0}; // Number of received messages, 0 if none was received yet
+};
+
+/**
+ * Latest value of one message type.
+ * Trivially copyable messages use a seqlock: one writer publishes without waiting, any number of readers copy
+ * without locks and retry only if they raced with the writer. Other messages fall back to a mutex.
+ */
+template<typename T, bool = std::is_trivially_copyable_v<T>>
+class SnapshotSlot {
+public:
+    /**
+     * Publish new value, must only be called from one thread
+     */
+    void publish(const T& message, std::chrono::steady_clock::time_point timestamp) {
+        Snapshot<T> snapshot;
+        snapshot.message   = message;
+        snapshot.timestamp = timestamp;
+        snapshot.sequence  = ++_published;
+        write(snapshot);
+    }
+
+    /**
+     * Drop the value, readers see an invalid snapshot until the next publish. Writer thread only.
+     */
+    void clear() { write(Snapshot<T>{}); }
+
+    [[nodiscard]] Snapshot<T> read() const {
+        std::array<uint64_t, kWords> words{};
+        uint64_t                     before = 0;
+        uint64_t                     after  = 0;
+        do {
+            before = _version.load(std::memory_order_acquire);
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = _words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = _version.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1) != 0);
+
+        Snapshot<T> snapshot;
+        std::memcpy(static_cast<void*>(&snapshot), words.data(), sizeof(snapshot));
+        return snapshot;
+    }
+
+private:
+    static_assert(std::is_trivially_copyable_v<Snapshot<T>>);
+
+    static constexpr size_t kWords = (sizeof(Snapshot<T>) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    void write(const Snapshot<T>& snapshot) {
+        std::array<uint64_t, kWords> words{};
+        std::memcpy(words.data(), &snapshot, sizeof(snapshot));
+
+        // Odd version marks the write in progress
+        const auto version = _version.load(std::memory_order_relaxed);
+        _version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+        _version.store(version + 2, std::memory_order_release);
+    }
+
+    std::atomic<uint64_t>                     _version{0};
+    std::array<std::atomic<uint64_t>, kWords> _words{};
+    uint64_t                                  _published{0}; // Writer only
+};
+
+template<typename T>
+class SnapshotSlot<T, false> {
+public:
+    void publish(const T& message, std::chrono::steady_clock::time_point timestamp) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _snapshot.message   = message;
+        _snapshot.timestamp = timestamp;
+        ++_snapshot.sequence;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _snapshot = Snapshot<T>{};
+    }
+
+    [[nodiscard]] Snapshot<T> read() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _snapshot;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    Snapshot<T>        _snapshot;
+};
+
+/**
+ * Latest value of every received message type
+ */
+class SnapshotStore {
+public:
+    template<typename T>
+    void publish(const T& message, std::chrono::steady_clock::time_point timestamp) {
+        std::get<SnapshotSlot<T>>(_slots).publish(message, timestamp);
+    }
+
+    template<typename T>
+    void clear() {
+        std::get<SnapshotSlot<T>>(_slots).clear();
+    }
+
+    template<typename T>
+    [[nodiscard]] Snapshot<T> read() const {
+        return std::get<SnapshotSlot<T>>(_slots).read();
+    }
+
+private:
+    std::tuple<SnapshotSlot<FirmwareMessage>,
+               SnapshotSlot<HardwareIDMessage>,
+               SnapshotSlot<AutoFocusMessage>,
+               SnapshotSlot<ManualZoomMessage>,
+               SnapshotSlot<AbsoluteZoomMessage>,
+               SnapshotSlot<ManualFocusMessage>,
+               SnapshotSlot<GimbalRotationMessage>,
+               SnapshotSlot<GimbalCenterMessage>,
+               SnapshotSlot<FunctionFeedbackMessage>,
+               SnapshotSlot<GimbalAttitudeMessage>,
+               SnapshotSlot<GimbalControlAngleMessage>,
+               SnapshotSlot<CameraStatusInfoMessage>,
+               SnapshotSlot<DataStreamMessage>>
+        _slots;
+};
+
+} // namespace siyi
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QString>
+
+namespace siyi {
+
+/**
+ * Physical link to the cameras of one CameraManager
+ */
+struct TransportConfig {
+    enum class Type {
+        Udp,    // Any number of cameras, frames are routed by source address
+        Tcp,    // One camera over a persistent connection
+        Serial, // One camera on a UART, POSIX only
+    };
+
+    /**
+     * @param localPort Local UDP port, 0 picks any free port
+     */
+    static TransportConfig udp(quint16 localPort = 37260) {
+        TransportConfig config;
+        config.type      = Type::Udp;
+        config.localPort = localPort;
+        return config;
+    }
+
+    /**
+     * @param host Camera address
+     * @param port Camera TCP port
+     */
+    static TransportConfig tcp(const QString& host, quint16 port = 37260) {
+        TransportConfig config;
+        config.type = Type::Tcp;
+        config.host = host;
+        config.port = port;
+        return config;
+    }
+
+    /**
+     * @param device Serial device, e.g. /dev/ttyUSB0
+     * @param baudRate Baud rate
+     */
+    static TransportConfig serial(const QString& device, int baudRate = 115200) {
+        TransportConfig config;
+        config.type     = Type::Serial;
+        config.device   = device;
+        config.baudRate = baudRate;
+        return config;
+    }
+
+    Type    type{Type::Udp};
+    quint16 localPort{37260}; // Udp
+    QString host;             // Tcp
+    quint16 port{37260};      // Tcp
+    QString device;           // Serial
+    int     baudRate{115200}; // Serial
+};
+
+} // namespace siyi
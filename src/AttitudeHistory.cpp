@@ -0,0 +1,200 @@
+#include "AttitudeHistory.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace siyi {
+
+namespace {
+constexpr float kDegreesToRadians = 3.14159265358979f / 180.0f;
+constexpr float kRadiansToDegrees = 180.0f / 3.14159265358979f;
+
+/**
+ * Yaw about z, then pitch about y, then roll about x
+ */
+Quaternion fromEuler(float yaw, float pitch, float roll) {
+    const float cy = std::cos(yaw * kDegreesToRadians * 0.5f);
+    const float sy = std::sin(yaw * kDegreesToRadians * 0.5f);
+    const float cp = std::cos(pitch * kDegreesToRadians * 0.5f);
+    const float sp = std::sin(pitch * kDegreesToRadians * 0.5f);
+    const float cr = std::cos(roll * kDegreesToRadians * 0.5f);
+    const float sr = std::sin(roll * kDegreesToRadians * 0.5f);
+
+    Quaternion q;
+    q.w = cr * cp * cy + sr * sp * sy;
+    q.x = sr * cp * cy - cr * sp * sy;
+    q.y = cr * sp * cy + sr * cp * sy;
+    q.z = cr * cp * sy - sr * sp * cy;
+    return q;
+}
+
+void toEuler(const Quaternion& q, GimbalPose& pose) {
+    pose.roll  = std::atan2(2.0f * (q.w * q.x + q.y * q.z), 1.0f - 2.0f * (q.x * q.x + q.y * q.y)) * kRadiansToDegrees;
+    pose.pitch = std::asin(std::clamp(2.0f * (q.w * q.y - q.z * q.x), -1.0f, 1.0f)) * kRadiansToDegrees;
+    pose.yaw   = std::atan2(2.0f * (q.w * q.z + q.x * q.y), 1.0f - 2.0f * (q.y * q.y + q.z * q.z)) * kRadiansToDegrees;
+}
+
+/**
+ * Shortest-path spherical interpolation
+ * @param fraction 0 returns a, 1 returns b
+ */
+Quaternion slerp(const Quaternion& a, Quaternion b, float fraction) {
+    float dot = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+    if (dot < 0.0f) {
+        b   = {-b.w, -b.x, -b.y, -b.z};
+        dot = -dot;
+    }
+
+    float wa = 1.0f - fraction;
+    float wb = fraction;
+    // Nearly parallel samples, the linear blend is exact to float precision and avoids dividing by sin(0)
+    if (dot < 0.9995f) {
+        const float theta = std::acos(dot);
+        const float sine  = std::sin(theta);
+        wa                = std::sin(wa * theta) / sine;
+        wb                = std::sin(wb * theta) / sine;
+    }
+
+    Quaternion q{wa * a.w + wb * b.w, wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z};
+    const float norm = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    q                = {q.w / norm, q.x / norm, q.y / norm, q.z / norm};
+    return q;
+}
+
+int64_t nanoseconds(AttitudeHistory::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+} // namespace
+
+void AttitudeHistory::add(Clock::time_point time, const GimbalAttitudeMessage& message) {
+    const auto index = _count.load(std::memory_order_relaxed);
+    const auto ns    = nanoseconds(time);
+    // Interpolation needs ascending times, a late sample is dropped
+    if (index > 0 && ns < _time[slot(index - 1)].load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const auto yaw   = message.actualYaw();
+    const auto pitch = message.actualPitch();
+    const auto roll  = message.actualRoll();
+    const auto q     = fromEuler(yaw, pitch, roll);
+    const auto i     = slot(index);
+
+    // Odd version marks the write in progress
+    const auto version = _version.load(std::memory_order_relaxed);
+    _version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _time[i].store(ns, std::memory_order_relaxed);
+    _qw[i].store(q.w, std::memory_order_relaxed);
+    _qx[i].store(q.x, std::memory_order_relaxed);
+    _qy[i].store(q.y, std::memory_order_relaxed);
+    _qz[i].store(q.z, std::memory_order_relaxed);
+    _yaw[i].store(yaw, std::memory_order_relaxed);
+    _pitch[i].store(pitch, std::memory_order_relaxed);
+    _roll[i].store(roll, std::memory_order_relaxed);
+    _yawRate[i].store(message.actualYawVelocity(), std::memory_order_relaxed);
+    _pitchRate[i].store(message.actualPitchVelocity(), std::memory_order_relaxed);
+    _rollRate[i].store(message.actualRollVelocity(), std::memory_order_relaxed);
+    _count.store(index + 1, std::memory_order_relaxed);
+    _version.store(version + 2, std::memory_order_release);
+}
+
+GimbalPose AttitudeHistory::poseAt(Clock::time_point time, std::chrono::nanoseconds horizon) const {
+    GimbalPose pose;
+    posesAt(&time, 1, &pose, horizon);
+    return pose;
+}
+
+void AttitudeHistory::posesAt(const Clock::time_point* times, size_t count, GimbalPose* poses, std::chrono::nanoseconds horizon) const {
+    uint64_t before = 0;
+    uint64_t after  = 0;
+    do {
+        before = _version.load(std::memory_order_acquire);
+        if ((before & 1) != 0) {
+            continue;
+        }
+        const auto last  = _count.load(std::memory_order_relaxed);
+        const auto first = last > kCapacity ? last - kCapacity : 0;
+        uint64_t   hint  = first;
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0 && times[i] < times[i - 1]) {
+                hint = first;
+            }
+            poses[i] = resolve(times[i], first, last, hint, horizon);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = _version.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1) != 0);
+}
+
+size_t AttitudeHistory::size() const {
+    return static_cast<size_t>(std::min<uint64_t>(_count.load(std::memory_order_acquire), kCapacity));
+}
+
+GimbalPose AttitudeHistory::resolve(Clock::time_point time, uint64_t first, uint64_t last, uint64_t& hint,
+                                    std::chrono::nanoseconds horizon) const {
+    GimbalPose pose;
+    pose.time = time;
+    if (first == last) {
+        return pose;
+    }
+
+    const auto ns     = nanoseconds(time);
+    const auto latest = last - 1;
+    const auto newest = _time[slot(latest)].load(std::memory_order_relaxed);
+    if (ns >= newest) {
+        const auto ahead = ns - newest;
+        if (ahead > horizon.count()) {
+            return pose;
+        }
+        // Angular velocity is reported as Euler rates, advancing the angles is exact to first order
+        const auto i       = slot(latest);
+        const auto seconds = static_cast<float>(ahead) * 1e-9f;
+        pose.orientation   = fromEuler(_yaw[i].load(std::memory_order_relaxed) + _yawRate[i].load(std::memory_order_relaxed) * seconds,
+                                     _pitch[i].load(std::memory_order_relaxed) + _pitchRate[i].load(std::memory_order_relaxed) * seconds,
+                                     _roll[i].load(std::memory_order_relaxed) + _rollRate[i].load(std::memory_order_relaxed) * seconds);
+        pose.source        = ahead == 0 ? GimbalPose::Source::Interpolated : GimbalPose::Source::Extrapolated;
+        toEuler(pose.orientation, pose);
+        hint = latest;
+        return pose;
+    }
+    if (ns < _time[slot(first)].load(std::memory_order_relaxed)) {
+        return pose;
+    }
+
+    // First sample after time within [hint, latest], the sample before it is at or before time
+    auto low  = std::max(hint, first);
+    auto high = latest;
+    while (low < high) {
+        const auto middle = low + (high - low) / 2;
+        if (_time[slot(middle)].load(std::memory_order_relaxed) <= ns) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    const auto next     = std::max(low, first + 1);
+    const auto previous = next - 1;
+    hint                = previous;
+
+    const auto a  = slot(previous);
+    const auto b  = slot(next);
+    const auto t0 = _time[a].load(std::memory_order_relaxed);
+    const auto t1 = _time[b].load(std::memory_order_relaxed);
+
+    const Quaternion qa{_qw[a].load(std::memory_order_relaxed),
+                        _qx[a].load(std::memory_order_relaxed),
+                        _qy[a].load(std::memory_order_relaxed),
+                        _qz[a].load(std::memory_order_relaxed)};
+    const Quaternion qb{_qw[b].load(std::memory_order_relaxed),
+                        _qx[b].load(std::memory_order_relaxed),
+                        _qy[b].load(std::memory_order_relaxed),
+                        _qz[b].load(std::memory_order_relaxed)};
+    const auto fraction = t1 > t0 ? static_cast<float>(static_cast<double>(ns - t0) / static_cast<double>(t1 - t0)) : 0.0f;
+    pose.orientation    = slerp(qa, qb, std::clamp(fraction, 0.0f, 1.0f));
+    pose.source         = GimbalPose::Source::Interpolated;
+    toEuler(pose.orientation, pose);
+    return pose;
+}
+
+} // namespace siyi
@@ -0,0 +1,158 @@
+#include "BatchedUdpSocket.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(siyiBatchedSocket, "siyi.sdk.batchedSocket")
+
+namespace siyi {
+
+namespace {
+std::chrono::nanoseconds clockTime(clockid_t clock) {
+    timespec time{};
+    ::clock_gettime(clock, &time);
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+}
+} // namespace
+
+BatchedUdpSocket::BatchedUdpSocket() {
+    // Headers point to the preallocated buffers once and for all
+    for (size_t i = 0; i < kBatchSize; ++i) {
+        _receiveVectors[i].iov_base            = _receiveBuffers[i].data();
+        _receiveVectors[i].iov_len             = kReceiveBufferSize;
+        _receiveHeaders[i].msg_hdr.msg_iov     = &_receiveVectors[i];
+        _receiveHeaders[i].msg_hdr.msg_iovlen  = 1;
+        _receiveHeaders[i].msg_hdr.msg_name    = &_receiveAddresses[i];
+        _receiveHeaders[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+
+        _sendVectors[i].iov_base            = _sendBuffers[i].data();
+        _sendHeaders[i].msg_hdr.msg_iov     = &_sendVectors[i];
+        _sendHeaders[i].msg_hdr.msg_iovlen  = 1;
+        _sendHeaders[i].msg_hdr.msg_name    = &_sendAddresses[i];
+        _sendHeaders[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+}
+
+BatchedUdpSocket::~BatchedUdpSocket() {
+    if (_fd >= 0) {
+        // Frames queued right before shutdown, e.g. a final stop or center command, still go out
+        flush();
+        ::close(_fd);
+    }
+}
+
+bool BatchedUdpSocket::bind(uint16_t port) {
+    _fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fd < 0) {
+        qCWarning(siyiBatchedSocket) << "Failed to create socket:" << std::strerror(errno);
+        return false;
+    }
+
+    sockaddr_in address{};
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port        = htons(port);
+    if (::bind(_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        qCWarning(siyiBatchedSocket) << "Failed to bind to port" << port << ":" << std::strerror(errno);
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    // Discovery probes may go to a broadcast address
+    const int enable = 1;
+    if (::setsockopt(_fd, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable)) != 0) {
+        qCWarning(siyiBatchedSocket) << "Broadcast unavailable:" << std::strerror(errno);
+    }
+
+    // Kernel receive timestamps, the receive call time is used without them
+    _kernelTimestamps = ::setsockopt(_fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) == 0;
+    if (!_kernelTimestamps) {
+        qCWarning(siyiBatchedSocket) << "Kernel receive timestamps unavailable:" << std::strerror(errno);
+    }
+    return true;
+}
+
+size_t BatchedUdpSocket::receiveBatch() {
+    if (_fd < 0) {
+        return 0;
+    }
+    // The kernel shrinks msg_namelen and msg_controllen to the received sizes
+    for (size_t i = 0; i < kBatchSize; ++i) {
+        _receiveHeaders[i].msg_hdr.msg_namelen    = sizeof(sockaddr_in);
+        _receiveHeaders[i].msg_hdr.msg_control    = _kernelTimestamps ? _receiveControl[i].data() : nullptr;
+        _receiveHeaders[i].msg_hdr.msg_controllen = _kernelTimestamps ? kControlSize : 0;
+    }
+    const int count = ::recvmmsg(_fd, _receiveHeaders.data(), kBatchSize, MSG_DONTWAIT, nullptr);
+
+    if (count < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            qCWarning(siyiBatchedSocket) << "recvmmsg failed:" << std::strerror(errno);
+        }
+        return 0;
+    }
+
+    // steady_clock is CLOCK_MONOTONIC; reading the realtime clock between two monotonic reads halves the offset error
+    const auto before = clockTime(CLOCK_MONOTONIC);
+    const auto now    = clockTime(CLOCK_REALTIME);
+    const auto after  = clockTime(CLOCK_MONOTONIC);
+    _realtimeToSteady = before + (after - before) / 2 - now;
+    _batchTime        = Clock::time_point(std::chrono::duration_cast<Clock::duration>(after));
+
+    return static_cast<size_t>(count);
+}
+
+BatchedUdpSocket::Clock::time_point BatchedUdpSocket::receiveTime(size_t index) {
+    auto& header = _receiveHeaders[index].msg_hdr;
+    for (auto* control = CMSG_FIRSTHDR(&header); control != nullptr; control = CMSG_NXTHDR(&header, control)) {
+        if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec time{};
+            std::memcpy(&time, CMSG_DATA(control), sizeof(time));
+            const auto realtime = std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+            return Clock::time_point(std::chrono::duration_cast<Clock::duration>(realtime + _realtimeToSteady));
+        }
+    }
+    return _batchTime;
+}
+
+bool BatchedUdpSocket::queue(const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port) {
+    if (length > kSendBufferSize) {
+        qCWarning(siyiBatchedSocket) << "Datagram too large to queue:" << length;
+        return false;
+    }
+    if (_queued == kBatchSize) {
+        flush();
+    }
+    std::memcpy(_sendBuffers[_queued].data(), data, length);
+    _sendVectors[_queued].iov_len           = length;
+    _sendAddresses[_queued].sin_family      = AF_INET;
+    _sendAddresses[_queued].sin_addr.s_addr = htonl(ipv4Address);
+    _sendAddresses[_queued].sin_port        = htons(port);
+    ++_queued;
+    return true;
+}
+
+size_t BatchedUdpSocket::flush() {
+    size_t sent = 0;
+    while (sent < _queued) {
+        const int count = ::sendmmsg(_fd, _sendHeaders.data() + sent, static_cast<unsigned int>(_queued - sent), 0);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qCWarning(siyiBatchedSocket) << "sendmmsg failed, dropping" << (_queued - sent) << "datagrams:" << std::strerror(errno);
+            break;
+        }
+        sent += static_cast<size_t>(count);
+    }
+    _queued = 0;
+    return sent;
+}
+
+} // namespace siyi
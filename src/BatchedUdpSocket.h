@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "Frame.h"
+
+namespace siyi {
+
+/**
+ * Linux UDP socket that drains and flushes datagrams in batches with recvmmsg/sendmmsg.
+ * All buffers are preallocated, nothing is allocated per datagram.
+ * Received datagrams carry the kernel receive timestamp (SO_TIMESTAMPNS) converted to steady_clock.
+ */
+class BatchedUdpSocket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kBatchSize         = 32;   // Datagrams per syscall
+    static constexpr size_t kReceiveBufferSize = 2048; // Larger datagrams are truncated
+    static constexpr size_t kSendBufferSize    = FrameBuffer::kCapacity;
+    static constexpr size_t kControlSize       = CMSG_SPACE(sizeof(timespec));
+
+    BatchedUdpSocket();
+    ~BatchedUdpSocket();
+
+    BatchedUdpSocket(const BatchedUdpSocket&)            = delete;
+    BatchedUdpSocket& operator=(const BatchedUdpSocket&) = delete;
+
+    /**
+     * Open non-blocking socket bound to any address
+     * @param port Local port
+     * @return True if socket is bound
+     */
+    bool bind(uint16_t port);
+
+    [[nodiscard]] int descriptor() const { return _fd; }
+
+    /**
+     * @return True if the kernel timestamps received datagrams, false if they carry the time of the receive call
+     */
+    [[nodiscard]] bool kernelTimestamps() const { return _kernelTimestamps; }
+
+    /**
+     * Drain socket
+     * @param callback Called as callback(const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port,
+     * Clock::time_point receiveTime) for every datagram with the sender address in host byte order, the data is
+     * only valid during the call
+     * @return Number of received datagrams
+     */
+    template<typename Callback>
+    size_t receive(Callback&& callback) {
+        size_t total = 0;
+        size_t count = 0;
+        do {
+            count = receiveBatch();
+            for (size_t i = 0; i < count; ++i) {
+                callback(_receiveBuffers[i].data(),
+                         static_cast<size_t>(_receiveHeaders[i].msg_len),
+                         ntohl(_receiveAddresses[i].sin_addr.s_addr),
+                         ntohs(_receiveAddresses[i].sin_port),
+                         receiveTime(i));
+            }
+            total += count;
+        } while (count == kBatchSize);
+        return total;
+    }
+
+    /**
+     * Queue datagram, flushes first if the queue is full
+     * @param data Datagram
+     * @param length Datagram length, at most kSendBufferSize
+     * @param ipv4Address Destination address in host byte order
+     * @param port Destination port
+     * @return False if datagram is too large
+     */
+    bool queue(const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port);
+
+    /**
+     * Send all queued datagrams
+     * @return Number of datagrams sent, queued datagrams are dropped on error
+     */
+    size_t flush();
+
+    [[nodiscard]] size_t queued() const { return _queued; }
+
+private:
+    /**
+     * Receive up to kBatchSize datagrams without blocking
+     * @return Number of received datagrams
+     */
+    size_t receiveBatch();
+
+    /**
+     * Kernel timestamp of datagram of the last batch, time of the receive call if it has none
+     * @param index Datagram index in the batch
+     */
+    Clock::time_point receiveTime(size_t index);
+
+private:
+    int  _fd{-1};
+    bool _kernelTimestamps{false};
+
+    // Time of the last receive call and the offset from CLOCK_REALTIME of kernel timestamps to steady_clock
+    Clock::time_point        _batchTime{};
+    std::chrono::nanoseconds _realtimeToSteady{0};
+
+    std::array<std::array<uint8_t, kReceiveBufferSize>, kBatchSize> _receiveBuffers{};
+    std::array<iovec, kBatchSize>                                    _receiveVectors{};
+    std::array<sockaddr_in, kBatchSize>                              _receiveAddresses{};
+    std::array<std::array<uint8_t, kControlSize>, kBatchSize>        _receiveControl{};
+    std::array<mmsghdr, kBatchSize>                                  _receiveHeaders{};
+
+    std::array<std::array<uint8_t, kSendBufferSize>, kBatchSize> _sendBuffers{};
+    std::array<iovec, kBatchSize>                                 _sendVectors{};
+    std::array<sockaddr_in, kBatchSize>                           _sendAddresses{};
+    std::array<mmsghdr, kBatchSize>                               _sendHeaders{};
+    size_t                                                        _queued{0};
+};
+
+} // namespace siyi
@@ -1,8 +1,13 @@
 #include "CameraApi.h"
 
+#include <algorithm>
+
 #include <QLoggingCategory>
 
+#include "CameraManager.h"
+#include "CommandCoalescer.h"
 #include "CommunicationWorker.h"
+#include "LinkMetrics.h"
 #include "MessageBuilder.h"
 
 namespace siyi {
@@ -10,87 +15,331 @@ namespace siyi {
 Q_LOGGING_CATEGORY(siyiSdkApi, "siyi.sdk.api")
 
 namespace {
-constexpr auto kGimbalAttitudeTimeout{100}; // Update gimbal timeout in ms
+constexpr auto kGimbalAttitudeTimeout{100};                  // Update gimbal timeout in ms
+constexpr auto kDataStreamAckTimeout = std::chrono::seconds(1); // Fall back to polling without acknowledge
+constexpr auto kHandshakeAttempt     = std::chrono::milliseconds(200); // Retransmit interval of startup requests
+constexpr int  kStreamWatchdogPeriods{5};                               // Missed pushes before the stream counts as lost
+
+/**
+ * @return Time between two pushes of a data stream
+ */
+std::chrono::milliseconds streamPeriod(DataStreamFrequency frequency) {
+    switch (frequency) {
+    case DataStreamFrequency::Hz2:
+        return std::chrono::milliseconds(500);
+    case DataStreamFrequency::Hz4:
+        return std::chrono::milliseconds(250);
+    case DataStreamFrequency::Hz5:
+        return std::chrono::milliseconds(200);
+    case DataStreamFrequency::Hz10:
+        return std::chrono::milliseconds(100);
+    case DataStreamFrequency::Hz20:
+        return std::chrono::milliseconds(50);
+    case DataStreamFrequency::Hz50:
+        return std::chrono::milliseconds(20);
+    case DataStreamFrequency::Hz100:
+        return std::chrono::milliseconds(10);
+    case DataStreamFrequency::Off:
+    default:
+        return std::chrono::milliseconds(0);
+    }
 }
 
+bool sameHardwareID(const HardwareIDMessage& lhs, const HardwareIDMessage& rhs) {
+    return lhs.hardwareID.size() == rhs.hardwareID.size()
+           && std::equal(lhs.hardwareID.data(), lhs.hardwareID.data() + lhs.hardwareID.size(), rhs.hardwareID.data());
+}
+
+bool sameIdentity(const CameraIdentity& lhs, const CameraIdentity& rhs) {
+    return sameHardwareID(lhs.hardwareID, rhs.hardwareID) && lhs.hardwareID.modelId == rhs.hardwareID.modelId
+           && lhs.firmware.boardVersion == rhs.firmware.boardVersion
+           && lhs.firmware.gimbalFirmwareVersion == rhs.firmware.gimbalFirmwareVersion
+           && lhs.firmware.zoomFirmwareVersion == rhs.firmware.zoomFirmwareVersion && lhs.capabilities == rhs.capabilities;
+}
+
+/**
+ * Store latest control frame and schedule a flush on the communication thread if none is pending
+ */
+void sendCoalesced(CommandCoalescer& coalescer, CommunicationWorker* worker, int cameraId, CommandCoalescer::Slot slot,
+                   const FrameBuffer& frame) {
+    if (coalescer.store(slot, frame)) {
+        QMetaObject::invokeMethod(
+            worker, [worker, cameraId] { worker->flushCoalesced(cameraId); }, Qt::QueuedConnection);
+    }
+}
+} // namespace
+
 CameraApi::CameraApi(const QString& serverIp, quint16 port, QObject* parent)
+    : CameraApi(serverIp, port, nullptr, parent) {}
+
+CameraApi::CameraApi(const QString& serverIp, quint16 port, std::shared_ptr<IdentityCache> identityCache, QObject* parent)
     : QObject(parent)
-    , _messageBuilder(std::make_shared<MessageBuilder>()) {
+    , _ownManager(std::make_unique<CameraManager>(port))
+    , _manager(_ownManager.get())
+    , _messageBuilder(std::make_shared<MessageBuilder>())
+    , _identityCache(std::move(identityCache)) {
     init(serverIp, port);
+}
 
-    // Send messages about hardware ID and firmware
-    auto message = _messageBuilder->buildHardwareIDRequestMessage();
-    emit sendMessage(message);
+CameraApi::CameraApi(CameraManager& manager, const QString& serverIp, quint16 port, QObject* parent)
+    : QObject(parent)
+    , _manager(&manager)
+    , _messageBuilder(std::make_shared<MessageBuilder>())
+    , _identityCache(manager._identityCache) {
+    init(serverIp, port);
 }
 
 CameraApi::~CameraApi() {
-    _siyiCommunicationWorkerThread.quit();
-    _siyiCommunicationWorkerThread.wait();
+    // No callbacks are invoked once the camera is unregistered
+    _manager->runOnWorkerThread([cameraId = _cameraId](CommunicationWorker& worker) { worker.removeCamera(cameraId); });
 }
 
 void CameraApi::init(const QString& serverIp, quint16 port) {
-    // Create Connection
-    _siyiCommunicationWorker = new CommunicationWorker(_messageBuilder, serverIp, port);
+    _siyiCommunicationWorker = _manager->_worker;
+    _serverIp                = serverIp;
+    _port                    = port;
+
+    // File access stays off the communication thread, the entry is read here and written on the cache thread
+    const auto cached = _identityCache ? _identityCache->load(serverIp, port) : std::nullopt;
 
-    // Receive message for processing
-    // connect(_siyiConnection, &Connection::messageReceived, this, &Api::processSdkMessage);
-    connect(_siyiCommunicationWorker, &CommunicationWorker::messageReceived, [this](const QVariant& message, quint8 command) {
-        processSdkMessage(message, command);
+    // Register camera and receive messages for processing
+    _manager->runOnWorkerThread([this, &serverIp, port, &cached](CommunicationWorker& worker) {
+        _cameraId = worker.addCamera(serverIp, port);
+        worker.addMessageHandler(_cameraId, this);
+        _metrics   = worker.metrics(_cameraId);
+        _coalescer = worker.coalescer(_cameraId);
+        if (cached) {
+            applyCachedIdentity(*cached);
+        }
+
+        // Startup requests go out back to back, the camera is ready one round trip later.
+        // Until the link is up the worker holds them.
+        _handshakeStarted = std::chrono::steady_clock::now();
+        sendHandshakeRequest(HandshakeHardwareID);
+        sendHandshakeRequest(HandshakeFirmware);
+        sendHandshakeRequest(HandshakeGimbalInfo);
     });
 
     // Send message to camera
-    connect(this, &CameraApi::sendMessage, _siyiCommunicationWorker, &CommunicationWorker::sendMessage);
-
-    // Create thread and move connection worker to it
-    _siyiCommunicationWorker->moveToThread(&_siyiCommunicationWorkerThread);
-    connect(&_siyiCommunicationWorkerThread, &QThread::finished, _siyiCommunicationWorker, &QObject::deleteLater);
-    connect(&_siyiCommunicationWorkerThread, &QThread::started, _siyiCommunicationWorker, &CommunicationWorker::init);
-    _siyiCommunicationWorkerThread.start();
+    auto* worker = _siyiCommunicationWorker;
+    connect(this, &CameraApi::sendMessage, worker, [worker, cameraId = _cameraId](const QByteArray& message) {
+        worker->sendMessage(cameraId, message);
+    });
 
     // Start gimbal attitude timer
     _gimbalAttitudeTimer = startTimer(kGimbalAttitudeTimeout);
 }
 
-void CameraApi::processSdkMessage(const QVariant& message, quint8 command) {
-    switch (static_cast<Command>(command)) {
-    case Command::UNKNOWN:
-    case Command::AUTO_FOCUS:
-    case Command::MANUAL_ZOOM:
-    case Command::ABSOLUTE_ZOOM:
-    case Command::GIMBAL_ROTATION:
-    case Command::GIMBAL_CENTER:
-    case Command::FUNC_FEEDBACK_INFO:
-    case Command::PHOTO_VIDEO_HDR:
-    case Command::GIMBAL_CONTROL_ANGLE:
+bool CameraApi::waitForReady(std::chrono::milliseconds timeout) {
+    return _readyFuture.wait_for(timeout) == std::future_status::ready && _readyFuture.get();
+}
+
+void CameraApi::setReadyDeadline(std::chrono::milliseconds deadline) {
+    _manager->runOnWorkerThread([this, deadline](CommunicationWorker&) { _readyDeadline = deadline; });
+}
+
+void CameraApi::sendHandshakeRequest(HandshakeStep step) {
+    QByteArray message;
+    Command    responseCommand = Command::UNKNOWN;
+    switch (step) {
+    case HandshakeHardwareID:
+        message         = _messageBuilder->buildHardwareIDRequestMessage();
+        responseCommand = Command::ACQUIRE_HW_ID;
         break;
-    case Command::MANUAL_FOCUS: {
-        manualFocusMessage = message.value<ManualFocusMessage>();
+    case HandshakeFirmware:
+        message         = _messageBuilder->buildFirmwareRequestMessage();
+        responseCommand = Command::ACQUIRE_FW_VER;
         break;
-    }
-    case Command::ACQUIRE_FW_VER: {
-        firmwareMessage = message.value<FirmwareMessage>();
+    case HandshakeGimbalInfo:
+        message         = _messageBuilder->buildAcquireGimbalInfoRequestMessage();
+        responseCommand = Command::ACQUIRE_GIMBAL_INFO;
         break;
+    case HandshakeStepCount:
+        return;
     }
-    case Command::ACQUIRE_HW_ID: {
-        hardwareIDMessage = message.value<HardwareIDMessage>();
-        getCameraType();
-        break;
+
+    // The last attempt ends at the deadline
+    const auto     deadline  = _handshakeStarted + _readyDeadline;
+    const auto     remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    RequestOptions options;
+    options.timeout = std::clamp(remaining, std::chrono::milliseconds(1), kHandshakeAttempt);
+    options.retries = 0;
+    _siyiCommunicationWorker->sendRequest(_cameraId, message, responseCommand, options, [this, step](const RequestResult& result) {
+        onHandshakeResult(step, result);
+    });
+}
+
+void CameraApi::onHandshakeResult(HandshakeStep step, const RequestResult& result) {
+    // Replies are parsed before the request completes, so a received reply is already marked
+    if (_handshakeFinished || result.status == RequestStatus::Cancelled || (_handshakeReceived & (1U << step)) != 0) {
+        return;
     }
-    case Command::ACQUIRE_GIMBAL_ATT: {
-        gimbalAttitudeMessage = message.value<GimbalAttitudeMessage>();
-        emit updateGimbalAngles();
-        break;
+    if (std::chrono::steady_clock::now() - _handshakeStarted >= _readyDeadline) {
+        finishHandshake(false);
+        return;
     }
-    case Command::ACQUIRE_GIMBAL_INFO:
-        cameraStatusInfoMessage = message.value<CameraStatusInfoMessage>();
-        break;
+    sendHandshakeRequest(step);
+}
+
+void CameraApi::handshakeReceived(HandshakeStep step) {
+    _handshakeReceived |= static_cast<uint8_t>(1U << step);
+    // A reply in flight at the deadline still makes the camera ready
+    if (_handshakeReceived == (1U << HandshakeStepCount) - 1 && (!_handshakeFinished || !isReady())) {
+        finishHandshake(true);
+    }
+}
+
+void CameraApi::finishHandshake(bool success) {
+    _handshakeFinished = true;
+    resolveReady(success);
+    if (success) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _handshakeStarted);
+        qCInfo(siyiSdkApi) << "Camera" << _cameraId << "ready after" << elapsed.count() << "us";
+        storeIdentity();
+        emit ready();
+    } else {
+        qCWarning(siyiSdkApi) << "Camera" << _cameraId << "did not answer the startup requests in time";
+        emit readyTimedOut();
+    }
+}
+
+void CameraApi::resolveReady(bool success) {
+    _ready.store(success, std::memory_order_release);
+    if (!_readyResolved) {
+        _readyResolved = true;
+        _readyPromise.set_value(success);
+    }
+}
+
+void CameraApi::applyCachedIdentity(const CameraIdentity& identity) {
+    // Cached messages carry no receive time
+    _snapshots.publish(identity.hardwareID, {});
+    _snapshots.publish(identity.firmware, {});
+    getCameraType(identity.hardwareID);
+    _capabilities.store(identity.capabilities, std::memory_order_relaxed);
+    _cachedIdentity = identity;
+    resolveReady(true);
+}
+
+void CameraApi::storeIdentity() {
+    if (!_identityCache) {
+        return;
+    }
+    CameraIdentity identity;
+    identity.hardwareID   = snapshot<HardwareIDMessage>().message;
+    identity.firmware     = snapshot<FirmwareMessage>().message;
+    identity.capabilities = capabilities();
+    if (_cachedIdentity && sameIdentity(*_cachedIdentity, identity)) {
+        return;
+    }
+    // The file is written on the cache thread of the manager, a failed write is logged there and retried on the next change
+    _cachedIdentity = identity;
+    _manager->writeIdentityCache([cache = _identityCache, address = _serverIp, port = _port, identity] {
+        cache->store(address, port, identity);
+    });
+}
+
+void CameraApi::addMessageHandler(MessageHandler* handler) {
+    auto* worker = _siyiCommunicationWorker;
+    QMetaObject::invokeMethod(
+        worker, [worker, cameraId = _cameraId, handler] { worker->addMessageHandler(cameraId, handler); }, Qt::QueuedConnection);
+}
+
+void CameraApi::removeMessageHandler(MessageHandler* handler) {
+    _manager->runOnWorkerThread([cameraId = _cameraId, handler](CommunicationWorker& worker) {
+        worker.removeMessageHandler(cameraId, handler);
+    });
+}
+
+LinkStats CameraApi::stats() const {
+    auto stats             = _metrics->snapshot();
+    stats.coalescedUpdates = _coalescer->coalesced();
+    return stats;
+}
+
+void CameraApi::onFirmware(const FirmwareMessage& message) {
+    publish(message);
+    handshakeReceived(HandshakeFirmware);
+}
+
+void CameraApi::onHardwareID(const HardwareIDMessage& message) {
+    if (_cachedIdentity && !sameHardwareID(_cachedIdentity->hardwareID, message)) {
+        qCWarning(siyiSdkApi) << "Camera" << _cameraId << "hardware ID differs from the identity cache, dropping the entry";
+        _manager->writeIdentityCache([cache = _identityCache, address = _serverIp, port = _port] { cache->remove(address, port); });
+        _cachedIdentity.reset();
+        // Nothing learned about the other camera holds, a firmware reply that already arrived has a receive time
+        _capabilities.store(0, std::memory_order_relaxed);
+        if (snapshot<FirmwareMessage>().timestamp == std::chrono::steady_clock::time_point{}) {
+            _snapshots.clear<FirmwareMessage>();
+        }
+    }
+    getCameraType(message);
+    publish(message);
+    handshakeReceived(HandshakeHardwareID);
+}
+
+void CameraApi::onAutoFocus(const AutoFocusMessage& message) {
+    publish(message);
+}
+
+void CameraApi::onManualZoom(const ManualZoomMessage& message) {
+    publish(message);
+}
+
+void CameraApi::onAbsoluteZoom(const AbsoluteZoomMessage& message) {
+    publish(message);
+}
+
+void CameraApi::onManualFocus(const ManualFocusMessage& message) {
+    publish(message);
+}
+
+void CameraApi::onGimbalRotation(const GimbalRotationMessage& message) {
+    publish(message);
+}
+
+void CameraApi::onGimbalCenter(const GimbalCenterMessage& message) {
+    publish(message);
+}
+
+void CameraApi::onFunctionFeedback(const FunctionFeedbackMessage& message) {
+    publish(message);
+}
+
+void CameraApi::onGimbalAttitude(const GimbalAttitudeMessage& message) {
+    publish(message);
+    _attitudeHistory.add(receiveInfo().receiveTime, message);
+    emit updateGimbalAngles();
+}
+
+void CameraApi::onGimbalControlAngle(const GimbalControlAngleMessage& message) {
+    publish(message);
+}
+
+void CameraApi::onCameraStatusInfo(const CameraStatusInfoMessage& message) {
+    publish(message);
+    handshakeReceived(HandshakeGimbalInfo);
+}
+
+void CameraApi::onDataStream(const DataStreamMessage& message) {
+    publish(message);
+    if (message.dataType == static_cast<uint8_t>(DataStreamType::Attitude)) {
+        auto frequency = _attitudeStreamFrequency.load(std::memory_order_relaxed);
+        _attitudeStreaming.store(frequency != DataStreamFrequency::Off, std::memory_order_relaxed);
+        if (frequency != DataStreamFrequency::Off && (capabilities() & CapabilityAttitudeStream) == 0) {
+            _capabilities.fetch_or(CapabilityAttitudeStream, std::memory_order_relaxed);
+            // Before the handshake completes, the capability is stored with the identity
+            if (_handshakeFinished && isReady()) {
+                storeIdentity();
+            }
+        }
     }
 }
 
 bool CameraApi::setAngles(float pan, float tilt) {
-    auto message = _messageBuilder->buildSetGimbalControlAngleRequestMessage(static_cast<int16_t>(pan * 10),
-                                                                             static_cast<int16_t>(tilt * 10));
-    emit sendMessage(message);
+    FrameBuffer frame;
+    _messageBuilder->buildSetGimbalControlAngleRequestMessage(frame, static_cast<int16_t>(pan * 10), static_cast<int16_t>(tilt * 10));
+    sendCoalesced(*_coalescer, _siyiCommunicationWorker, _cameraId, CommandCoalescer::GimbalControlAngle, frame);
     return true;
 }
 
@@ -101,11 +350,36 @@ bool CameraApi::setGimbalCenter() {
 }
 
 bool CameraApi::setRates(float panRate, float tiltRate) {
-    auto message = _messageBuilder->buildGimbalRotationRequestMessage(static_cast<int8_t>(panRate), static_cast<int8_t>(tiltRate));
-    emit sendMessage(message);
+    FrameBuffer frame;
+    _messageBuilder->buildGimbalRotationRequestMessage(frame, static_cast<int8_t>(panRate), static_cast<int8_t>(tiltRate));
+    sendCoalesced(*_coalescer, _siyiCommunicationWorker, _cameraId, CommandCoalescer::GimbalRotation, frame);
     return true;
 }
 
+std::unique_ptr<RealtimeSender> CameraApi::createRealtimeSender() {
+    std::unique_ptr<RealtimeSender> sender;
+    _manager->runOnWorkerThread([this, &sender](CommunicationWorker& worker) {
+        sender = worker.createRealtimeSender(_cameraId, _messageBuilder);
+    });
+    return sender;
+}
+
+void CameraApi::setMaxControlRate(double rateHz) {
+    _coalescer->setMaxRate(rateHz);
+}
+
+void CameraApi::setMaxFrameRate(double rateHz) {
+    auto* worker = _siyiCommunicationWorker;
+    QMetaObject::invokeMethod(
+        worker, [worker, cameraId = _cameraId, rateHz] { worker->setMaxFrameRate(cameraId, rateHz); }, Qt::QueuedConnection);
+}
+
+void CameraApi::setSequenceFallback(bool enabled) {
+    auto* worker = _siyiCommunicationWorker;
+    QMetaObject::invokeMethod(
+        worker, [worker, cameraId = _cameraId, enabled] { worker->setSequenceFallback(cameraId, enabled); }, Qt::QueuedConnection);
+}
+
 bool CameraApi::takePhoto() {
     auto message = _messageBuilder->buildTakePhotoRequestMessage();
     emit sendMessage(message);
@@ -147,6 +421,25 @@ bool CameraApi::setCameraMode(uint8_t mode) {
     return false;
 }
 
+bool CameraApi::subscribeGimbalAttitude(DataStreamFrequency frequency) {
+    _attitudeStreamFrequency.store(frequency, std::memory_order_relaxed);
+    // A gimbal known to stream, e.g. from the identity cache, stops being polled without waiting for the
+    // acknowledge; the stream watchdog resumes polling if no push arrives
+    const bool knownStream = frequency != DataStreamFrequency::Off && (capabilities() & CapabilityAttitudeStream) != 0;
+    if (frequency == DataStreamFrequency::Off) {
+        // Resume polling right away, the gimbal stops pushing once it handles the request
+        _attitudeStreaming.store(false, std::memory_order_relaxed);
+    } else if (knownStream) {
+        _attitudeStreaming.store(true, std::memory_order_relaxed);
+    }
+    _attitudeStreamRequested = std::chrono::steady_clock::now();
+    _attitudeStreamPending   = frequency != DataStreamFrequency::Off && !knownStream;
+
+    auto message = _messageBuilder->buildDataStreamRequestMessage(DataStreamType::Attitude, frequency);
+    emit sendMessage(message);
+    return true;
+}
+
 bool CameraApi::zoom(uint8_t zoomValue) {
     auto message = _messageBuilder->buildAbsoluteZoomRequestMessage(zoomValue);
     emit sendMessage(message);
@@ -166,21 +459,111 @@ bool CameraApi::manualFocus(int8_t direction) {
     return true;
 }
 
+std::future<RequestResult> CameraApi::setAnglesAsync(float pan, float tilt, RequestCallback callback, const RequestOptions& options) {
+    auto message = _messageBuilder->buildSetGimbalControlAngleRequestMessage(static_cast<int16_t>(pan * 10),
+                                                                             static_cast<int16_t>(tilt * 10));
+    return sendRequest(message, Command::GIMBAL_CONTROL_ANGLE, std::move(callback), options);
+}
+
+std::future<RequestResult> CameraApi::setGimbalCenterAsync(RequestCallback callback, const RequestOptions& options) {
+    auto message = _messageBuilder->buildGimbalCenterRequestMessage();
+    return sendRequest(message, Command::GIMBAL_CENTER, std::move(callback), options);
+}
+
+std::future<RequestResult> CameraApi::setRatesAsync(float panRate, float tiltRate, RequestCallback callback,
+                                                    const RequestOptions& options) {
+    auto message = _messageBuilder->buildGimbalRotationRequestMessage(static_cast<int8_t>(panRate), static_cast<int8_t>(tiltRate));
+    return sendRequest(message, Command::GIMBAL_ROTATION, std::move(callback), options);
+}
+
+std::future<RequestResult> CameraApi::takePhotoAsync(RequestCallback callback, const RequestOptions& options) {
+    // Photo result is reported through function feedback
+    auto message = _messageBuilder->buildTakePhotoRequestMessage();
+    return sendRequest(message, Command::FUNC_FEEDBACK_INFO, std::move(callback), options);
+}
+
+std::future<RequestResult> CameraApi::zoomAsync(uint8_t zoomValue, RequestCallback callback, const RequestOptions& options) {
+    auto message = _messageBuilder->buildAbsoluteZoomRequestMessage(zoomValue);
+    return sendRequest(message, Command::ABSOLUTE_ZOOM, std::move(callback), options);
+}
+
+std::future<RequestResult> CameraApi::zoomDirectionAsync(int8_t direction, RequestCallback callback, const RequestOptions& options) {
+    auto message = _messageBuilder->buildManualZoomRequestMessage(direction);
+    return sendRequest(message, Command::MANUAL_ZOOM, std::move(callback), options);
+}
+
+std::future<RequestResult> CameraApi::manualFocusAsync(int8_t direction, RequestCallback callback, const RequestOptions& options) {
+    auto message = _messageBuilder->buildManualFocusShotRequestMessage(direction);
+    return sendRequest(message, Command::MANUAL_FOCUS, std::move(callback), options);
+}
+
+std::future<RequestResult> CameraApi::sendRequest(const QByteArray& message, Command responseCommand, RequestCallback callback,
+                                                  const RequestOptions& options) {
+    auto promise = std::make_shared<std::promise<RequestResult>>();
+    auto future  = promise->get_future();
+
+    // Queued after earlier sendMessage() emissions, so requests keep their order on the wire
+    auto* worker = _siyiCommunicationWorker;
+    QMetaObject::invokeMethod(
+        worker,
+        [worker, cameraId = _cameraId, message, responseCommand, options, callback = std::move(callback), promise]() mutable {
+            auto complete = [callback = std::move(callback), promise](const RequestResult& result) {
+                if (callback) {
+                    callback(result);
+                }
+                promise->set_value(result);
+            };
+            worker->sendRequest(cameraId, message, responseCommand, options, std::move(complete));
+        },
+        Qt::QueuedConnection);
+    return future;
+}
+
 void CameraApi::timerEvent(QTimerEvent* e) {
-    if (initialized() && e->timerId() == _gimbalAttitudeTimer) {
+    if (e->timerId() != _gimbalAttitudeTimer) {
+        return;
+    }
+
+    if (gimbalAttitudeStreaming()) {
+        _attitudeStreamPending = false;
+        // Pushes stop without notice when the gimbal reboots or drops the subscription
+        const auto frequency = _attitudeStreamFrequency.load(std::memory_order_relaxed);
+        const auto timeout   = std::max<std::chrono::milliseconds>(kStreamWatchdogPeriods * streamPeriod(frequency),
+                                                                  std::chrono::milliseconds(2 * kGimbalAttitudeTimeout));
+        const auto lastSeen  = std::max(snapshot<GimbalAttitudeMessage>().timestamp, _attitudeStreamRequested);
+        if (std::chrono::steady_clock::now() - lastSeen <= timeout) {
+            return;
+        }
+        qCWarning(siyiSdkApi) << "Attitude data stream stopped, polling gimbal attitude and subscribing again";
+        subscribeGimbalAttitude(frequency);
+        // Poll until the gimbal acknowledges again, even if it is known to stream
+        _attitudeStreaming.store(false, std::memory_order_relaxed);
+        _attitudeStreamPending = true;
+    }
+
+    if (_attitudeStreamPending && std::chrono::steady_clock::now() - _attitudeStreamRequested > kDataStreamAckTimeout) {
+        qCWarning(siyiSdkApi) << "Attitude data stream is not acknowledged, polling gimbal attitude";
+        _attitudeStreamPending = false;
+    }
+
+    if (initialized()) {
         emit sendMessage(_messageBuilder->buildAcquireGimbalAttitudeRequestMessage());
     }
 }
 
-void CameraApi::getCameraType() {
-    static QMap<uint16_t, CameraType> cameraTypeMap{
+CameraApi::CameraType CameraApi::cameraTypeFromModel(uint16_t modelId) {
+    static const QMap<uint16_t, CameraType> cameraTypeMap{
         {0x6B, CameraType::ZR10},
         {0x73, CameraType::A8Mini},
         {0x75, CameraType::A2Mini},
         {0x78, CameraType::ZR30},
         {0x7A, CameraType::ZT30},
     };
-    _cameraType = cameraTypeMap.value(hardwareIDMessage.modelId, CameraType::Unknown);
+    return cameraTypeMap.value(modelId, CameraType::Unknown);
+}
+
+void CameraApi::getCameraType(const HardwareIDMessage& message) {
+    _cameraType.store(cameraTypeFromModel(message.modelId), std::memory_order_relaxed);
 }
 
 } // namespace siyi
@@ -0,0 +1,105 @@
+#include "CameraManager.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "CommunicationWorker.h"
+
+namespace siyi {
+
+CameraManager::CameraManager(quint16 localPort, QObject* parent)
+    : CameraManager(TransportConfig::udp(localPort), parent) {}
+
+CameraManager::CameraManager(const TransportConfig& config, QObject* parent)
+    : QObject(parent)
+    , _worker(new CommunicationWorker(config)) {
+    // Create thread and move connection worker to it
+    _worker->moveToThread(&_workerThread);
+    connect(&_workerThread, &QThread::finished, _worker, &QObject::deleteLater);
+    connect(&_workerThread, &QThread::started, _worker, &CommunicationWorker::init);
+    _workerThread.start();
+
+    // A single thread keeps the writes of a camera in order
+    _identityCacheWriter.setMaxThreadCount(1);
+}
+
+CameraManager::~CameraManager() {
+    // Cameras unregister from the worker, so they must go before the thread
+    _cameras.clear();
+    _workerThread.quit();
+    _workerThread.wait();
+}
+
+CameraApi* CameraManager::addCamera(const QString& serverIp, quint16 port) {
+    _cameras.push_back(std::unique_ptr<CameraApi>(new CameraApi(*this, serverIp, port)));
+    return _cameras.back().get();
+}
+
+void CameraManager::removeCamera(CameraApi* camera) {
+    _cameras.erase(std::remove_if(_cameras.begin(), _cameras.end(), [camera](const auto& item) { return item.get() == camera; }),
+                   _cameras.end());
+}
+
+void CameraManager::writeIdentityCache(std::function<void()> write) {
+    _identityCacheWriter.start(std::move(write));
+}
+
+std::vector<CameraApi*> CameraManager::cameras() const {
+    std::vector<CameraApi*> cameras;
+    cameras.reserve(_cameras.size());
+    for (const auto& camera : _cameras) {
+        cameras.push_back(camera.get());
+    }
+    return cameras;
+}
+
+bool CameraManager::startCapture(const QString& path) {
+    bool started = false;
+    runOnWorkerThread([&path, &started](CommunicationWorker& worker) { started = worker.startCapture(path); });
+    return started;
+}
+
+CaptureStats CameraManager::stopCapture() {
+    CaptureStats stats;
+    runOnWorkerThread([&stats](CommunicationWorker& worker) { stats = worker.stopCapture(); });
+    return stats;
+}
+
+std::future<ReplayStats> CameraManager::replayCapture(const QString& path, ReplaySpeed speed) {
+    auto promise = std::make_shared<std::promise<ReplayStats>>();
+    auto future  = promise->get_future();
+
+    auto* worker = _worker;
+    QMetaObject::invokeMethod(
+        worker,
+        [worker, path, speed, promise] {
+            worker->replayCapture(path, speed, [promise](const ReplayStats& stats) { promise->set_value(stats); });
+        },
+        Qt::QueuedConnection);
+    return future;
+}
+
+std::future<std::vector<DiscoveredCamera>> CameraManager::discover(const DiscoveryOptions& options) {
+    auto promise = std::make_shared<std::promise<std::vector<DiscoveredCamera>>>();
+    auto future  = promise->get_future();
+
+    auto* worker = _worker;
+    QMetaObject::invokeMethod(
+        worker,
+        [worker, options, promise] {
+            worker->discoverCameras(options, [promise](std::vector<DiscoveredCamera> cameras) { promise->set_value(std::move(cameras)); });
+        },
+        Qt::QueuedConnection);
+    return future;
+}
+
+void CameraManager::runOnWorkerThread(const std::function<void(CommunicationWorker&)>& function) {
+    auto* worker = _worker;
+    if (QThread::currentThread() == &_workerThread) {
+        function(*worker);
+        return;
+    }
+    QMetaObject::invokeMethod(worker, [worker, &function] { function(*worker); }, Qt::BlockingQueuedConnection);
+}
+
+} // namespace siyi
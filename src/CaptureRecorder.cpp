@@ -0,0 +1,146 @@
+#include "CaptureRecorder.h"
+
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(siyiSdkCapture, "siyi.sdk.capture")
+
+namespace siyi {
+
+namespace {
+/**
+ * Single writer increment
+ */
+void increment(std::atomic<uint64_t>& counter, uint64_t value = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+} // namespace
+
+std::unique_ptr<CaptureRecorder> CaptureRecorder::open(const QString& path, size_t bufferSize) {
+    auto* file = std::fopen(path.toLocal8Bit().constData(), "wb");
+    if (file == nullptr) {
+        qCWarning(siyiSdkCapture) << "Cannot create capture file" << path;
+        return nullptr;
+    }
+    uint8_t header[capture::kFileHeaderSize];
+    capture::writeFileHeader(header);
+    if (std::fwrite(header, 1, sizeof(header), file) != sizeof(header)) {
+        qCWarning(siyiSdkCapture) << "Cannot write capture file" << path;
+        std::fclose(file);
+        return nullptr;
+    }
+    return std::unique_ptr<CaptureRecorder>(new CaptureRecorder(file, bufferSize));
+}
+
+CaptureRecorder::CaptureRecorder(std::FILE* file, size_t bufferSize)
+    : _file(file)
+    , _bufferSize(bufferSize)
+    , _bytes(capture::kFileHeaderSize) {
+    // Buffers are swapped, never reallocated
+    _active.reserve(bufferSize);
+    _pending.reserve(bufferSize);
+    _writing.reserve(bufferSize);
+    _lastHandOver = Clock::now();
+    _writer       = std::thread([this] { writerLoop(); });
+}
+
+CaptureRecorder::~CaptureRecorder() {
+    close();
+}
+
+CaptureStats CaptureRecorder::close() {
+    if (_file == nullptr) {
+        return stats();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _writer.join();
+
+    // The writer drained the older pending buffer before it stopped
+    write(_active);
+    std::fclose(_file);
+    _file = nullptr;
+    return stats();
+}
+
+void CaptureRecorder::record(capture::Direction direction, int cameraId, const uint8_t* data, size_t length, Clock::time_point now) {
+    const auto size = capture::kRecordHeaderSize + length;
+    if (_file == nullptr || length > capture::kMaxFrameSize || size > _bufferSize) {
+        increment(_dropped);
+        return;
+    }
+    if (_active.size() + size > _bufferSize && !handOver(now)) {
+        increment(_dropped);
+        return;
+    }
+
+    capture::Record record;
+    record.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count());
+    record.direction   = direction;
+    record.cameraId    = static_cast<uint8_t>(cameraId);
+    record.length      = length;
+
+    uint8_t header[capture::kRecordHeaderSize];
+    capture::writeRecordHeader(header, record);
+    _active.insert(_active.end(), header, header + sizeof(header));
+    _active.insert(_active.end(), data, data + length);
+    increment(_records);
+
+    if (now - _lastHandOver >= kFlushInterval) {
+        handOver(now);
+    }
+}
+
+CaptureStats CaptureRecorder::stats() const {
+    CaptureStats stats;
+    stats.records        = _records.load(std::memory_order_relaxed);
+    stats.bytes          = _bytes.load(std::memory_order_relaxed);
+    stats.droppedRecords = _dropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool CaptureRecorder::handOver(Clock::time_point now) {
+    _lastHandOver = now;
+    if (_active.empty()) {
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_pending.empty()) {
+            return false;
+        }
+        _pending.swap(_active);
+    }
+    _wake.notify_one();
+    return true;
+}
+
+void CaptureRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _wake.wait(lock, [this] { return _stop || !_pending.empty(); });
+        if (_pending.empty()) {
+            return;
+        }
+        _writing.swap(_pending);
+        lock.unlock();
+        write(_writing);
+        lock.lock();
+    }
+}
+
+void CaptureRecorder::write(std::vector<uint8_t>& buffer) {
+    if (buffer.empty()) {
+        return;
+    }
+    const auto written = std::fwrite(buffer.data(), 1, buffer.size(), _file);
+    if (written != buffer.size()) {
+        qCWarning(siyiSdkCapture) << "Capture file write failed, capture is truncated";
+    }
+    increment(_bytes, written);
+    buffer.clear();
+}
+
+} // namespace siyi
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QString>
+
+#include "Capture.h"
+#include "CaptureFormat.h"
+
+namespace siyi {
+
+/**
+ * Appends raw frames to a capture file.
+ * The communication thread copies every frame into an in-memory buffer; full buffers are handed to a writer
+ * thread, so the hot path never touches the file. Frames are dropped and counted if the writer falls behind
+ * by more than one buffer.
+ */
+class CaptureRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t                    kDefaultBufferSize{1 << 20};
+    static constexpr std::chrono::milliseconds kFlushInterval{200}; // Hand over partial buffers at least this often
+
+    /**
+     * @brief Create file and start writer thread
+     * @param path Capture file, replaced if it exists
+     * @param bufferSize Size of each of the two buffers
+     * @return Recorder or nullptr if the file cannot be created
+     */
+    static std::unique_ptr<CaptureRecorder> open(const QString& path, size_t bufferSize = kDefaultBufferSize);
+
+    /**
+     * Closes the file if close() was not called
+     */
+    ~CaptureRecorder();
+
+    CaptureRecorder(const CaptureRecorder&)            = delete;
+    CaptureRecorder& operator=(const CaptureRecorder&) = delete;
+
+    /**
+     * @brief Append frame, communication thread only
+     * @param direction Received or sent
+     * @param cameraId Camera id of the communication worker
+     * @param data Frame
+     * @param length Frame length
+     * @param now Receive or send time
+     */
+    void record(capture::Direction direction, int cameraId, const uint8_t* data, size_t length, Clock::time_point now);
+
+    /**
+     * @brief Write remaining frames, stop the writer thread and close the file, communication thread only.
+     * Frames recorded afterwards are dropped.
+     * @return Final counters
+     */
+    CaptureStats close();
+
+    /**
+     * @return Counters, any thread
+     */
+    [[nodiscard]] CaptureStats stats() const;
+
+private:
+    CaptureRecorder(std::FILE* file, size_t bufferSize);
+
+    /**
+     * Pass active buffer to the writer thread
+     * @return False if the writer still holds the previous buffer
+     */
+    bool handOver(Clock::time_point now);
+
+    void writerLoop();
+
+    /**
+     * Write buffer to the file and clear it
+     */
+    void write(std::vector<uint8_t>& buffer);
+
+private:
+    std::FILE*           _file{nullptr};
+    size_t               _bufferSize{0};
+    std::vector<uint8_t> _active;  // Communication thread
+    std::vector<uint8_t> _pending; // Guarded by _mutex
+    std::vector<uint8_t> _writing; // Writer thread
+    Clock::time_point    _lastHandOver{};
+
+    std::mutex              _mutex;
+    std::condition_variable _wake;
+    bool                    _stop{false};
+    std::thread             _writer;
+
+    std::atomic<uint64_t> _records{0};
+    std::atomic<uint64_t> _bytes{0};
+    std::atomic<uint64_t> _dropped{0};
+};
+
+} // namespace siyi
@@ -0,0 +1,22 @@
+#include "CommandCoalescer.h"
+
+namespace siyi {
+
+bool CommandCoalescer::store(Slot slot, const FrameBuffer& frame) {
+    auto&           entry = _entries[slot];
+    std::lock_guard lock(entry.mutex);
+    entry.frame = frame;
+    if (entry.pending) {
+        _coalesced.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    entry.pending = true;
+    return true;
+}
+
+void CommandCoalescer::setMaxRate(double rateHz) {
+    const auto interval = rateHz > 0 ? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / rateHz)) : std::chrono::nanoseconds(0);
+    _minInterval.store(interval, std::memory_order_relaxed);
+}
+
+} // namespace siyi
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#include "Frame.h"
+
+namespace siyi {
+
+/**
+ * Last-writer-wins outbound stage for continuous control commands.
+ * Callers store the latest encoded frame of a slot from any thread, the communication thread sends it no
+ * faster than the configured rate. Updates stored while a frame is still waiting replace it and are counted
+ * as coalesced.
+ */
+class CommandCoalescer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Slot : size_t {
+        GimbalRotation,
+        GimbalControlAngle,
+        SlotCount,
+    };
+
+    /**
+     * Store latest frame of slot, any thread
+     * @param slot Slot
+     * @param frame Encoded frame
+     * @return True if the slot was empty and a flush must be scheduled on the communication thread
+     */
+    bool store(Slot slot, const FrameBuffer& frame);
+
+    /**
+     * Send waiting frames whose slot is past the minimum interval, communication thread only
+     * @param now Current time
+     * @param send Sends one frame
+     * @return Time until the next frame may be sent, empty if nothing is waiting
+     */
+    template<typename Send>
+    std::optional<std::chrono::nanoseconds> flush(Clock::time_point now, Send&& send);
+
+    /**
+     * Limit send rate of every slot
+     * @param rateHz Maximum frames per second and slot, 0 or less disables the limit
+     */
+    void setMaxRate(double rateHz);
+
+    /**
+     * @return Number of updates replaced before they were sent
+     */
+    [[nodiscard]] uint64_t coalesced() const { return _coalesced.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        std::mutex        mutex;
+        FrameBuffer       frame;
+        bool              pending{false};
+        Clock::time_point lastSent{}; // Communication thread only
+    };
+
+private:
+    std::array<Entry, SlotCount>          _entries;
+    std::atomic<std::chrono::nanoseconds> _minInterval{std::chrono::milliseconds(10)}; // 100 Hz
+    std::atomic<uint64_t>                 _coalesced{0};
+};
+
+template<typename Send>
+std::optional<std::chrono::nanoseconds> CommandCoalescer::flush(Clock::time_point now, Send&& send) {
+    const auto                              minInterval = _minInterval.load(std::memory_order_relaxed);
+    std::optional<std::chrono::nanoseconds> wait;
+    for (auto& entry : _entries) {
+        FrameBuffer frame;
+        {
+            std::lock_guard lock(entry.mutex);
+            if (!entry.pending) {
+                continue;
+            }
+            const auto elapsed = now - entry.lastSent;
+            if (elapsed < minInterval) {
+                const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(minInterval - elapsed);
+                wait                 = wait ? std::min(*wait, remaining) : remaining;
+                continue;
+            }
+            frame          = entry.frame;
+            entry.pending  = false;
+            entry.lastSent = now;
+        }
+        send(frame);
+    }
+    return wait;
+}
+
+} // namespace siyi
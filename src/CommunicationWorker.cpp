@@ -1,79 +1,640 @@
 #include "CommunicationWorker.h"
 
+#include <algorithm>
+
 #include <QLoggingCategory>
 
-#include "MessageParser.h"
+#include "MessageDispatch.h"
 
 Q_LOGGING_CATEGORY(siyiSdkConnection, "siyi.sdk.connection")
 
 namespace siyi {
 
-CommunicationWorker::CommunicationWorker(std::shared_ptr<MessageBuilder>& messageBuilder,
-                                         const QString&                   serverIp,
-                                         quint16                          port,
-                                         QObject*                         parent)
-    : QObject(parent)
-    , _messageBuilder(messageBuilder)
-    , _cameraAddress(serverIp)
-    , _port(port) {
-    // Fill parsers map
-    addParser(new FirmwareMessageParser);
-    addParser(new HardwareIDMessageParser);
-    addParser(new AutoFocusMessageParser);
-    addParser(new ManualZoomMessageParser);
-    addParser(new AbsoluteZoomMessageParser);
-    addParser(new ManualFocusMessageParser);
-    addParser(new GimbalRotationMessageParser);
-    addParser(new GimbalCenterMessageParser);
-    addParser(new FunctionFeedbackMessageParser);
-    addParser(new GimbalAttitudeMessageParser);
-    addParser(new GimbalControlAngleMessageParser);
-    addParser(new CameraStatusInfoMessageParser);
+namespace {
+constexpr size_t   kReplayBatch{4096};           // Records delivered per event loop iteration when replaying as fast as possible
+constexpr size_t   kMaxPendingFrames{64};        // Frames per camera held while the link is not ready
+constexpr uint32_t kMaxDiscoveryAddresses{65536}; // Addresses of a /16, bounds the probe burst
+constexpr uint32_t kDiscoveryBatch{32};           // Probes per flush, at most one sendmmsg batch
+
+const uint8_t* bytes(const QByteArray& message) {
+    return reinterpret_cast<const uint8_t*>(message.constData());
 }
 
+bool sameRequest(const QByteArray& lhs, const QByteArray& rhs) {
+    return OutboundScheduler::sameRequest(bytes(lhs), static_cast<size_t>(lhs.size()), bytes(rhs), static_cast<size_t>(rhs.size()));
+}
+} // namespace
+
+CommunicationWorker::CommunicationWorker(const TransportConfig& config, QObject* parent)
+    : QObject(parent)
+    , _config(config) {}
+
 CommunicationWorker::~CommunicationWorker() {
-    qDeleteAll(_parsers);
-}
-
-void CommunicationWorker::readPendingDatagrams() {
-    while (_socket->hasPendingDatagrams()) {
-        QByteArray datagram;
-        datagram.resize(static_cast<int>(_socket->pendingDatagramSize()));
-        _socket->readDatagram(datagram.data(), datagram.size());
-        // Decode message
-        const auto [data, dataLength, command, sequenceNumber] = _messageBuilder->decode(datagram);
-        // Notify about message received only if parser available
-        if (_parsers.contains(command)) {
-            auto message = _parsers.value(command)->parse(data);
-            emit messageReceived(message, static_cast<quint8>(command));
+    // Waiting callers get the partial result
+    if (_replay) {
+        finishReplay();
+    }
+    if (_discovery) {
+        finishDiscovery();
+    }
+}
+
+int CommunicationWorker::addCamera(const QString& serverIp, quint16 port) {
+    auto camera         = std::make_unique<Camera>();
+    camera->id          = _nextCameraId++;
+    camera->ipv4Address = QHostAddress(serverIp).toIPv4Address();
+    camera->port        = port;
+    _cameras.push_back(std::move(camera));
+    return _cameras.back()->id;
+}
+
+void CommunicationWorker::removeCamera(int cameraId) {
+    if (auto* camera = this->camera(cameraId)) {
+        camera->requests.cancelAll();
+    }
+    _cameras.erase(std::remove_if(_cameras.begin(), _cameras.end(), [cameraId](const auto& camera) { return camera->id == cameraId; }),
+                   _cameras.end());
+}
+
+void CommunicationWorker::addMessageHandler(int cameraId, MessageHandler* handler) {
+    if (auto* camera = this->camera(cameraId)) {
+        camera->parser.addHandler(handler);
+    }
+}
+
+void CommunicationWorker::removeMessageHandler(int cameraId, MessageHandler* handler) {
+    if (auto* camera = this->camera(cameraId)) {
+        camera->parser.removeHandler(handler);
+    }
+}
+
+std::shared_ptr<const LinkMetrics> CommunicationWorker::metrics(int cameraId) {
+    if (auto* camera = this->camera(cameraId)) {
+        return camera->metrics;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<CommandCoalescer> CommunicationWorker::coalescer(int cameraId) {
+    if (auto* camera = this->camera(cameraId)) {
+        return camera->coalescer;
+    }
+    return nullptr;
+}
+
+std::unique_ptr<RealtimeSender> CommunicationWorker::createRealtimeSender(int cameraId, std::shared_ptr<MessageBuilder> messageBuilder) {
+    // Writing to a stream from a second thread could interleave with frames of the communication thread
+    const intptr_t descriptor = _transport && _connected && !_transport->streamOriented() ? _transport->descriptor() : -1;
+
+    auto*    destination = camera(cameraId);
+    auto     metrics     = destination ? destination->metrics : std::make_shared<LinkMetrics>();
+    uint32_t ipv4Address = destination ? destination->ipv4Address : 0;
+    quint16  port        = destination ? destination->port : 0;
+    return std::unique_ptr<RealtimeSender>(
+        new RealtimeSender(std::move(messageBuilder), std::move(metrics), descriptor, ipv4Address, port));
+}
+
+CommunicationWorker::Camera* CommunicationWorker::camera(int cameraId) {
+    for (auto& camera : _cameras) {
+        if (camera->id == cameraId) {
+            return camera.get();
+        }
+    }
+    return nullptr;
+}
+
+void CommunicationWorker::processReceived(const uint8_t* data, size_t length, uint32_t ipv4Address, quint16 port,
+                                          Transport::Clock::time_point receiveTime) {
+    // Cameras answering a discovery probe are usually not added yet
+    const bool discoveryReply =
+        _discovery && !_transport->streamOriented() && discoveryReceived(data, length, ipv4Address, port, receiveTime);
+
+    auto* source = findSource(ipv4Address, port);
+    if (source == nullptr) {
+        if (!discoveryReply) {
+            qCDebug(siyiSdkConnection) << "Dropping data from unknown sender" << QHostAddress(ipv4Address).toString() << port;
+        }
+        return;
+    }
+
+    // Stream chunks may hold partial or several frames
+    if (_transport->streamOriented()) {
+        const auto before = _framer.stats();
+        // Frames completed by this chunk share its receive time
+        _framer.feed(data, length, [this, source, receiveTime](const FrameView& frame) {
+            if (_recorder) {
+                _recorder->record(capture::Direction::Received, source->id, frame.frame, frame.frameSize, receiveTime);
+            }
+            dispatchFrame(*source, frame, receiveTime);
+        });
+        const auto& after = _framer.stats();
+        source->metrics->decodeFailed(DecodeError::CrcMismatch, after.crcErrors - before.crcErrors);
+        source->metrics->decodeFailed(DecodeError::Truncated, after.lengthErrors - before.lengthErrors);
+        return;
+    }
+
+    // Datagrams are recorded before decoding, so corrupted frames can be replayed too
+    if (_recorder) {
+        _recorder->record(capture::Direction::Received, source->id, data, length, receiveTime);
+    }
+
+    // Decode message
+    const auto frame = MessageBuilder::decode(data, length);
+    if (!frame.valid()) {
+        source->metrics->decodeFailed(frame.error);
+        qCDebug(siyiSdkConnection) << "Dropping invalid frame, error" << static_cast<int>(frame.error);
+        return;
+    }
+    dispatchFrame(*source, frame, receiveTime);
+}
+
+CommunicationWorker::Camera* CommunicationWorker::findSource(uint32_t ipv4Address, quint16 port) {
+    if (_cameras.empty()) {
+        return nullptr;
+    }
+    // One camera per point-to-point link
+    if (_transport->streamOriented()) {
+        return _cameras.front().get();
+    }
+
+    // Few cameras per worker, a linear scan is the fastest lookup.
+    // Exact address and port match first, then any camera with the same address.
+    Camera* source = nullptr;
+    for (auto& camera : _cameras) {
+        if (camera->ipv4Address == ipv4Address) {
+            if (camera->port == port) {
+                return camera.get();
+            }
+            if (source == nullptr) {
+                source = camera.get();
+            }
+        }
+    }
+    return source;
+}
+
+void CommunicationWorker::dispatchFrame(Camera& source, const FrameView& frame, Transport::Clock::time_point receiveTime) {
+    // Latency is measured to the kernel receive time, without event loop delay
+    source.metrics->frameReceived(frame, receiveTime);
+
+    // Parse and notify subscribers, then complete pending request, so its callback sees the published message
+    if (!source.parser.parse(frame, receiveTime)) {
+        if (source.parser.hasParser(frame.command)) {
+            source.metrics->payloadTooShort();
         } else {
-            qCWarning(siyiSdkConnection) << "No parser for command" << static_cast<int>(command);
+            source.metrics->unknownCommand();
+        }
+    }
+    if (source.requests.complete(frame, receiveTime)) {
+        scheduleRequestTimer();
+    }
+}
+
+void CommunicationWorker::sendMessage(int cameraId, const QByteArray& message) {
+    auto* destination = camera(cameraId);
+    if (destination == nullptr) {
+        qCWarning(siyiSdkConnection) << "Unknown camera" << cameraId;
+        return;
+    }
+    if (!linkReady()) {
+        // Retransmissions and repeated requests differ only in sequence number and CRC, the latest replaces the waiting copy
+        auto&      pending = destination->pending;
+        const auto same    = std::find_if(pending.begin(), pending.end(), [&message](const QByteArray& waiting) {
+            return sameRequest(waiting, message);
+        });
+        if (same != pending.end()) {
+            *same = message;
+            return;
+        }
+        if (pending.size() >= kMaxPendingFrames) {
+            qCWarning(siyiSdkConnection) << "Link is not ready, dropping frame";
+            return;
+        }
+        pending.push_back(message);
+        return;
+    }
+    scheduleFrame(*destination, bytes(message), static_cast<size_t>(message.size()));
+}
+
+void CommunicationWorker::scheduleFrame(Camera& destination, const uint8_t* data, size_t length) {
+    if (!destination.scheduler.enqueue(data, length, OutboundScheduler::Clock::now())) {
+        qCDebug(siyiSdkConnection) << "Outbound queue of camera" << destination.id << "is full, dropping frame";
+    }
+    drainOutbound(destination);
+}
+
+void CommunicationWorker::drainOutbound(Camera& destination) {
+    auto wait = destination.scheduler.drain(OutboundScheduler::Clock::now(), [this, &destination](const FrameBuffer& frame) {
+        sendFrame(destination, frame.data(), frame.size());
+    });
+    if (!wait || destination.drainArmed) {
+        return;
+    }
+    destination.drainArmed = true;
+    const auto remaining   = std::chrono::ceil<std::chrono::milliseconds>(*wait);
+    const auto cameraId    = destination.id;
+    QTimer::singleShot(static_cast<int>(remaining.count()), Qt::PreciseTimer, this, [this, cameraId] {
+        if (auto* camera = this->camera(cameraId)) {
+            camera->drainArmed = false;
+            drainOutbound(*camera);
         }
+    });
+}
+
+void CommunicationWorker::sendFrame(Camera& destination, const uint8_t* data, size_t length) {
+    if (!_transport->send(data, length, destination.ipv4Address, destination.port)) {
+        qCWarning(siyiSdkConnection) << "Failed to send frame";
+        return;
+    }
+    const auto now = LinkMetrics::Clock::now();
+    destination.metrics->frameSent(data, length, now);
+    if (_recorder) {
+        _recorder->record(capture::Direction::Sent, destination.id, data, length, now);
     }
 }
 
-void CommunicationWorker::sendMessage(const QByteArray& message) {
-    if (!_connected) {
-        qCWarning(siyiSdkConnection) << "Not connected to camera";
+bool CommunicationWorker::linkReady() const {
+    return _connected && _transport->ready();
+}
+
+void CommunicationWorker::flushPending() {
+    for (auto& camera : _cameras) {
+        auto pending = std::move(camera->pending);
+        camera->pending.clear();
+        for (const auto& message : pending) {
+            scheduleFrame(*camera, bytes(message), static_cast<size_t>(message.size()));
+        }
+        // Control frames stored meanwhile wait for a flush
+        flushCoalesced(camera->id);
+    }
+}
+
+void CommunicationWorker::sendRequest(int cameraId, const QByteArray& message, Command responseCommand, const RequestOptions& options,
+                                      RequestCallback callback) {
+    auto* destination = camera(cameraId);
+    if (destination == nullptr) {
+        RequestResult result;
+        result.status  = RequestStatus::Cancelled;
+        result.command = responseCommand;
+        if (callback) {
+            callback(result);
+        }
         return;
     }
-    auto bytesSent = _socket->writeDatagram(message, _cameraAddress, _port);
-    if (bytesSent == -1) {
-        qCWarning(siyiSdkConnection) << "Failed to send data via UDP.";
+    sendMessage(cameraId, message);
+    auto complete = [metrics = destination->metrics, callback = std::move(callback)](const RequestResult& result) {
+        if (result.status == RequestStatus::TimedOut) {
+            metrics->requestTimeout();
+        }
+        if (callback) {
+            callback(result);
+        }
+    };
+    destination->requests.add(message, responseCommand, options, std::move(complete), RequestTracker::Clock::now());
+    scheduleRequestTimer();
+}
+
+void CommunicationWorker::flushCoalesced(int cameraId) {
+    auto* destination = camera(cameraId);
+    if (destination == nullptr || !linkReady()) {
+        return;
+    }
+    // Latest control values go through the scheduler, ahead of queued actions and polls
+    auto wait = destination->coalescer->flush(CommandCoalescer::Clock::now(), [this, destination](const FrameBuffer& frame) {
+        scheduleFrame(*destination, frame.data(), frame.size());
+    });
+    if (wait) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*wait);
+        QTimer::singleShot(static_cast<int>(remaining.count()), Qt::PreciseTimer, this, [this, cameraId] { flushCoalesced(cameraId); });
     }
 }
 
-void CommunicationWorker::addParser(ResponseMessageParser* parser) {
-    _parsers.insert(parser->command(), parser);
+void CommunicationWorker::setMaxFrameRate(int cameraId, double rateHz) {
+    if (auto* destination = camera(cameraId)) {
+        destination->scheduler.setMaxFrameRate(rateHz);
+        drainOutbound(*destination);
+    }
+}
+
+void CommunicationWorker::setSequenceFallback(int cameraId, bool enabled) {
+    if (auto* destination = camera(cameraId)) {
+        destination->requests.setSequenceFallback(enabled);
+    }
+}
+
+void CommunicationWorker::expireRequests() {
+    const auto now = RequestTracker::Clock::now();
+    // Callbacks may add or remove cameras, iterate over ids
+    std::vector<int> ids;
+    ids.reserve(_cameras.size());
+    for (const auto& camera : _cameras) {
+        ids.push_back(camera->id);
+    }
+    for (auto id : ids) {
+        if (auto* camera = this->camera(id)) {
+            camera->requests.expire(now, [this, id, metrics = camera->metrics.get()](const QByteArray& message) {
+                metrics->retransmission();
+                sendMessage(id, message);
+            });
+        }
+    }
+    scheduleRequestTimer();
+}
+
+void CommunicationWorker::scheduleRequestTimer() {
+    std::optional<RequestTracker::Clock::time_point> deadline;
+    for (const auto& camera : _cameras) {
+        auto next = camera->requests.nextDeadline();
+        if (next && (!deadline || *next < *deadline)) {
+            deadline = next;
+        }
+    }
+    if (!deadline) {
+        if (_requestTimer) {
+            _requestTimer->stop();
+        }
+        return;
+    }
+
+    if (_requestTimer == nullptr) {
+        _requestTimer = new QTimer(this);
+        _requestTimer->setSingleShot(true);
+        _requestTimer->setTimerType(Qt::PreciseTimer);
+        connect(_requestTimer, &QTimer::timeout, this, &CommunicationWorker::expireRequests);
+    }
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*deadline - RequestTracker::Clock::now());
+    _requestTimer->start(static_cast<int>(std::max<std::chrono::milliseconds::rep>(remaining.count(), 0)));
+}
+
+bool CommunicationWorker::startCapture(const QString& path) {
+    _recorder.reset();
+    _recorder = CaptureRecorder::open(path);
+    return _recorder != nullptr;
+}
+
+CaptureStats CommunicationWorker::stopCapture() {
+    if (!_recorder) {
+        return {};
+    }
+    const auto stats = _recorder->close();
+    _recorder.reset();
+    return stats;
+}
+
+void CommunicationWorker::replayCapture(const QString& path, ReplaySpeed speed, std::function<void(const ReplayStats&)> done) {
+    if (_replay) {
+        qCWarning(siyiSdkConnection) << "A capture is already being replayed";
+        if (done) {
+            done(ReplayStats{});
+        }
+        return;
+    }
+
+    _replay       = std::make_unique<Replay>(path);
+    _replay->done = std::move(done);
+    if (!_replay->file.open(QIODevice::ReadOnly)) {
+        qCWarning(siyiSdkConnection) << "Cannot open capture file" << path;
+        finishReplay();
+        return;
+    }
+
+    // Map the capture, so records are parsed in place
+    const uint8_t* data   = _replay->file.map(0, _replay->file.size());
+    size_t         length = static_cast<size_t>(_replay->file.size());
+    if (data == nullptr) {
+        _replay->content = _replay->file.readAll();
+        data             = reinterpret_cast<const uint8_t*>(_replay->content.constData());
+        length           = static_cast<size_t>(_replay->content.size());
+    }
+    _replay->reader = capture::Reader(data, length);
+    if (!_replay->reader.valid()) {
+        qCWarning(siyiSdkConnection) << "Not a capture file" << path;
+        finishReplay();
+        return;
+    }
+    _replay->stats.opened = true;
+    _replay->speed        = speed;
+    _replay->start        = std::chrono::steady_clock::now();
+    continueReplay();
+}
+
+void CommunicationWorker::continueReplay() {
+    if (!_replay) {
+        return;
+    }
+    auto& replay = *_replay;
+    for (size_t delivered = 0;; ++delivered) {
+        if (!replay.hasNext) {
+            if (!replay.reader.next(replay.next)) {
+                replay.stats.truncated = replay.reader.truncated();
+                finishReplay();
+                return;
+            }
+            if (!replay.firstTimestampNs) {
+                replay.firstTimestampNs = replay.next.timestampNs;
+            }
+            replay.lastTimestampNs = replay.next.timestampNs;
+            replay.hasNext         = true;
+        }
+
+        // Return to the event loop between records that are not due yet, or after a batch
+        if (replay.speed == ReplaySpeed::RealTime) {
+            const auto due = replay.start + std::chrono::nanoseconds(replay.next.timestampNs - *replay.firstTimestampNs);
+            const auto now = std::chrono::steady_clock::now();
+            if (due > now) {
+                const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(due - now);
+                QTimer::singleShot(static_cast<int>(remaining.count()), Qt::PreciseTimer, this, [this] { continueReplay(); });
+                return;
+            }
+        } else if (delivered == kReplayBatch) {
+            QTimer::singleShot(0, this, [this] { continueReplay(); });
+            return;
+        }
+
+        replay.hasNext = false;
+        replayRecord(replay.next);
+    }
+}
+
+void CommunicationWorker::replayRecord(const capture::Record& record) {
+    auto& stats = _replay->stats;
+    if (record.direction != capture::Direction::Received) {
+        ++stats.sentSkipped;
+        return;
+    }
+    auto* source = camera(record.cameraId);
+    if (source == nullptr) {
+        ++stats.unknownCamera;
+        return;
+    }
+    const auto frame = MessageBuilder::decode(record.data, record.length);
+    if (!frame.valid()) {
+        ++stats.decodeErrors;
+        return;
+    }
+    ++stats.framesReplayed;
+    // Replayed frames only reach the parsers and handlers, they must not complete live requests or count as link traffic
+    const auto replayTime = _replay->start + std::chrono::nanoseconds(record.timestampNs - *_replay->firstTimestampNs);
+    source->parser.parse(frame, replayTime);
+}
+
+void CommunicationWorker::finishReplay() {
+    // Handlers may start the next replay from the callback
+    auto replay = std::move(_replay);
+    if (replay->firstTimestampNs) {
+        replay->stats.captureDuration = std::chrono::nanoseconds(replay->lastTimestampNs - *replay->firstTimestampNs);
+    }
+    if (replay->stats.opened) {
+        replay->stats.elapsed = std::chrono::steady_clock::now() - replay->start;
+    }
+    if (replay->done) {
+        replay->done(replay->stats);
+    }
+}
+
+void CommunicationWorker::discoverCameras(const DiscoveryOptions& options, std::function<void(std::vector<DiscoveredCamera>)> done) {
+    const auto reject = [&done](const char* reason) {
+        qCWarning(siyiSdkConnection) << reason;
+        if (done) {
+            done({});
+        }
+    };
+    if (_discovery) {
+        reject("A discovery is already running");
+        return;
+    }
+    if (!_transport || _transport->streamOriented() || !linkReady()) {
+        reject("Discovery needs an open UDP transport");
+        return;
+    }
+    bool       firstValid = false;
+    bool       lastValid  = false;
+    const auto first      = QHostAddress(options.firstAddress).toIPv4Address(&firstValid);
+    const auto last       = QHostAddress(options.lastAddress).toIPv4Address(&lastValid);
+    if (!firstValid || !lastValid || last < first || last - first >= kMaxDiscoveryAddresses) {
+        reject("Invalid discovery range");
+        return;
+    }
+
+    _discovery             = std::make_unique<Discovery>();
+    auto& discovery        = *_discovery;
+    discovery.id           = ++_nextDiscoveryId;
+    discovery.firstAddress = first;
+    discovery.done         = std::move(done);
+
+    const uint32_t addresses = last - first + 1;
+    discovery.sentAt.reserve(addresses);
+
+    // One burst, the batched socket sends it with a few syscalls and every camera answers within one round trip.
+    // Each batch is flushed before it is stamped, so round-trip times do not include the wait for the flush timer.
+    FrameBuffer frame;
+    size_t      failed = 0;
+    _transport->flush();
+    for (uint32_t batch = 0; batch < addresses; batch += kDiscoveryBatch) {
+        const auto count = std::min(kDiscoveryBatch, addresses - batch);
+        for (uint32_t i = batch; i < batch + count; ++i) {
+            templates::kHardwareIDRequest.encode(frame, discovery.sequence++);
+            if (!_transport->send(frame.bytes.data(), frame.length, first + i, options.port)) {
+                ++failed;
+            }
+        }
+        _transport->flush();
+        discovery.sentAt.insert(discovery.sentAt.end(), count, Transport::Clock::now());
+    }
+    if (failed > 0) {
+        qCWarning(siyiSdkConnection) << "Failed to send" << failed << "of" << addresses << "discovery probes";
+    }
+
+    const auto id = discovery.id;
+    QTimer::singleShot(static_cast<int>(options.timeout.count()), Qt::PreciseTimer, this, [this, id] {
+        if (_discovery && _discovery->id == id) {
+            finishDiscovery();
+        }
+    });
+}
+
+bool CommunicationWorker::discoveryReceived(const uint8_t* data, size_t length, uint32_t ipv4Address, quint16 port,
+                                            Transport::Clock::time_point receiveTime) {
+    const auto frame = MessageBuilder::decode(data, length);
+    if (!frame.valid()) {
+        return false;
+    }
+
+    auto&      discovery = *_discovery;
+    const auto known     = [&discovery, ipv4Address, port]() -> DiscoveredCamera* {
+        for (size_t i = 0; i < discovery.cameras.size(); ++i) {
+            if (discovery.addresses[i] == ipv4Address && discovery.cameras[i].port == port) {
+                return &discovery.cameras[i];
+            }
+        }
+        return nullptr;
+    };
+
+    HardwareIDMessage hardwareID;
+    if (parseMessage(frame, hardwareID)) {
+        // Cameras reachable over several paths answer more than once
+        if (known() != nullptr) {
+            return true;
+        }
+        // A broadcast probe has one send time for every camera
+        const auto offset = ipv4Address - discovery.firstAddress;
+        const auto sentAt = offset < discovery.sentAt.size() ? discovery.sentAt[offset] : discovery.sentAt.back();
+
+        DiscoveredCamera camera;
+        camera.address       = QHostAddress(ipv4Address).toString();
+        camera.port          = port;
+        camera.type          = CameraApi::cameraTypeFromModel(hardwareID.modelId);
+        camera.hardwareID    = hardwareID;
+        camera.roundTripTime = receiveTime - sentAt;
+        discovery.cameras.push_back(camera);
+        discovery.addresses.push_back(ipv4Address);
+
+        // Only cameras that answered are asked for their firmware
+        FrameBuffer request;
+        templates::kFirmwareRequest.encode(request, discovery.sequence++);
+        if (!_transport->send(request.bytes.data(), request.length, ipv4Address, port)) {
+            qCWarning(siyiSdkConnection) << "Failed to request firmware of" << camera.address << port;
+        }
+        return true;
+    }
+
+    FirmwareMessage firmware;
+    if (parseMessage(frame, firmware)) {
+        if (auto* camera = known()) {
+            camera->firmware = firmware;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CommunicationWorker::finishDiscovery() {
+    // The callback may start the next discovery
+    auto discovery = std::move(_discovery);
+    qCDebug(siyiSdkConnection) << "Discovery found" << discovery->cameras.size() << "cameras";
+    if (discovery->done) {
+        discovery->done(std::move(discovery->cameras));
+    }
 }
 
 void CommunicationWorker::init() {
-    _socket = new QUdpSocket(this);
-    if (_socket->bind(QHostAddress::Any, _port)) {
-        _connected = _socket->state() == QUdpSocket::SocketState::BoundState;
-        connect(_socket, &QUdpSocket::readyRead, this, &CommunicationWorker::readPendingDatagrams);
-    } else {
-        qCWarning(siyiSdkConnection) << "Failed to bind to port";
+    _transport = Transport::create(_config);
+    if (!_transport) {
+        qCWarning(siyiSdkConnection) << "Transport is not available on this platform";
+        return;
+    }
+    // TCP connects in the background, frames sent before are queued until then
+    _transport->setReadyHandler([this] {
+        // A partial frame of the previous connection would swallow the first bytes of the new one
+        _framer.reset();
+        flushPending();
+    });
+    _connected = _transport->open(
+        [this](const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port, Transport::Clock::time_point receiveTime) {
+            processReceived(data, length, ipv4Address, port, receiveTime);
+        });
+    if (linkReady()) {
+        flushPending();
     }
 }
 
@@ -1,26 +1,124 @@
 #pragma once
 
-#include <QMap>
-#include <QUdpSocket>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
 
+#include <QFile>
+#include <QHostAddress>
+#include <QTimer>
+
+#include "Capture.h"
+#include "CaptureFormat.h"
+#include "CaptureRecorder.h"
+#include "CommandCoalescer.h"
+#include "Discovery.h"
+#include "LinkMetrics.h"
 #include "MessageBuilder.h"
 #include "MessageParser.h"
+#include "OutboundScheduler.h"
+#include "RealtimeSender.h"
+#include "RequestTracker.h"
+#include "StreamFramer.h"
+#include "Transport.h"
+#include "TransportConfig.h"
 
 namespace siyi {
 
+/**
+ * Owns the transport shared by all cameras of one thread. Received frames are demultiplexed
+ * by source address to the parser of the camera that sent them; point-to-point links (TCP, serial)
+ * serve the first camera.
+ */
 class CommunicationWorker : public QObject {
     Q_OBJECT
 
 public:
-    explicit CommunicationWorker(std::shared_ptr<MessageBuilder>& messageBuilder,
-                        const QString&                   serverIp = "192.168.144.25",
-                        quint16                          port     = 37260,
-                        QObject*                         parent   = nullptr);
+    explicit CommunicationWorker(const TransportConfig& config = TransportConfig::udp(), QObject* parent = nullptr);
     ~CommunicationWorker() override;
 
-signals:
-    // Emit received message and command
-    void messageReceived(const QVariant& message, quint8 command);
+    /**
+     * Register camera, call from the worker thread or before it starts
+     * @param serverIp Camera address
+     * @param port Camera port
+     * @return Camera id used by the other methods
+     */
+    int addCamera(const QString& serverIp, quint16 port);
+
+    /**
+     * Unregister camera, call from the worker thread or before it starts
+     * @param cameraId Camera id
+     */
+    void removeCamera(int cameraId);
+
+    /**
+     * Add subscriber for messages of camera, call before the worker thread starts or from the worker thread
+     * @param cameraId Camera id
+     * @param handler Subscriber
+     */
+    void addMessageHandler(int cameraId, MessageHandler* handler);
+
+    /**
+     * Remove subscriber, call from the worker thread
+     * @param cameraId Camera id
+     * @param handler Subscriber
+     */
+    void removeMessageHandler(int cameraId, MessageHandler* handler);
+
+    /**
+     * Link metrics of camera, call from the worker thread or before it starts
+     * @param cameraId Camera id
+     * @return Metrics readable from any thread, nullptr for unknown camera
+     */
+    std::shared_ptr<const LinkMetrics> metrics(int cameraId);
+
+    /**
+     * Coalescing stage of camera, call from the worker thread or before it starts
+     * @param cameraId Camera id
+     * @return Coalescer writable from any thread, nullptr for unknown camera
+     */
+    std::shared_ptr<CommandCoalescer> coalescer(int cameraId);
+
+    /**
+     * Create sender writing directly to the socket of this worker, call from the worker thread after init()
+     * @param cameraId Camera id
+     * @param messageBuilder Encoder of the camera
+     * @return Sender, RealtimeSender::valid() is false if the socket is not bound
+     */
+    std::unique_ptr<RealtimeSender> createRealtimeSender(int cameraId, std::shared_ptr<MessageBuilder> messageBuilder);
+
+    /**
+     * Record frames sent and received from now on, replacing a running capture. Call from the worker thread.
+     * @param path Capture file
+     * @return True if the file was created
+     */
+    bool startCapture(const QString& path);
+
+    /**
+     * Stop recording and write remaining frames, call from the worker thread
+     * @return Counters of the recording, empty if no capture was running
+     */
+    CaptureStats stopCapture();
+
+    /**
+     * Deliver received frames of a capture to the cameras with the recorded ids, call from the worker thread.
+     * Only one replay runs at a time, a second one completes immediately with ReplayStats::opened false.
+     * @param path Capture file
+     * @param speed Pacing
+     * @param done Invoked on the worker thread when the replay ends
+     */
+    void replayCapture(const QString& path, ReplaySpeed speed, std::function<void(const ReplayStats&)> done);
+
+    /**
+     * Probe an address range for cameras, call from the worker thread after init(). Hardware ID probes are sent
+     * in one burst and every camera that answers is asked for its firmware; replies are collected until the
+     * timeout, from cameras added to the worker or not. Probes are not recorded by a running capture.
+     * Only one discovery runs at a time, a second one completes immediately with no cameras.
+     * @param options Addresses and timeout
+     * @param done Invoked on the worker thread with the cameras that answered
+     */
+    void discoverCameras(const DiscoveryOptions& options, std::function<void(std::vector<DiscoveredCamera>)> done);
 
 public slots:
     /**
@@ -30,27 +128,193 @@ public slots:
 
     /**
      * Send message to camera
+     * @param cameraId Camera id
+     * @param message Message to send
+     */
+    void sendMessage(int cameraId, const QByteArray& message);
+
+    /**
+     * Send message and track its acknowledge, retransmitting it until the deadline of the last attempt.
+     * Call from the worker thread.
+     * @param cameraId Camera id
      * @param message Message to send
+     * @param responseCommand Command of the expected acknowledge
+     * @param options Deadline and retries
+     * @param callback Completion callback, invoked on the worker thread
      */
-    void sendMessage(const QByteArray& message);
+    void sendRequest(int cameraId, const QByteArray& message, Command responseCommand, const RequestOptions& options,
+                     RequestCallback callback);
+
+    /**
+     * Send latest coalesced frames of camera that are due, re-arms itself while frames are rate limited
+     * @param cameraId Camera id
+     */
+    void flushCoalesced(int cameraId);
+
+    /**
+     * Limit frame rate of camera, frames above it wait in the outbound scheduler
+     * @param cameraId Camera id
+     * @param rateHz Maximum frames per second, 0 or less disables the limit
+     */
+    void setMaxFrameRate(int cameraId, double rateHz);
+
+    /**
+     * Let acknowledges without a sequence number match complete requests of camera by command
+     * @param cameraId Camera id
+     * @param enabled True for firmware that does not echo request sequence numbers
+     */
+    void setSequenceFallback(int cameraId, bool enabled);
 
 private slots:
-    void readPendingDatagrams();
+    void expireRequests();
+
+    /**
+     * Deliver due records of the running replay, re-arms itself until the capture ends
+     */
+    void continueReplay();
 
 private:
     /**
-     * Add parser
-     * @param parser
+     * Camera known to the worker
+     */
+    struct Camera {
+        int                     id{-1};
+        uint32_t                ipv4Address{0}; // Host byte order
+        quint16                 port{0};
+        MessageParser           parser;
+        RequestTracker          requests;
+        std::vector<QByteArray> pending; // Frames sent while the link was not ready
+
+        std::shared_ptr<LinkMetrics>      metrics{std::make_shared<LinkMetrics>()};        // Shared with CameraApi::stats()
+        std::shared_ptr<CommandCoalescer> coalescer{std::make_shared<CommandCoalescer>()}; // Written by CameraApi
+        OutboundScheduler                 scheduler{*metrics};
+        bool                              drainArmed{false}; // Scheduler waits for the rate limit
+    };
+
+    /**
+     * Capture being replayed, the reader references the mapped file
+     */
+    struct Replay {
+        explicit Replay(const QString& path)
+            : file(path) {}
+
+        QFile                                   file;
+        QByteArray                              content; // Used if the file cannot be mapped
+        capture::Reader                         reader{nullptr, 0};
+        capture::Record                         next;
+        bool                                    hasNext{false};
+        ReplaySpeed                             speed{ReplaySpeed::RealTime};
+        std::optional<uint64_t>                 firstTimestampNs;
+        uint64_t                                lastTimestampNs{0};
+        std::chrono::steady_clock::time_point   start;
+        ReplayStats                             stats;
+        std::function<void(const ReplayStats&)> done;
+    };
+
+    /**
+     * Discovery in progress
+     */
+    struct Discovery {
+        uint64_t                                           id{0};
+        uint32_t                                           firstAddress{0}; // Host byte order
+        std::vector<Transport::Clock::time_point>          sentAt;          // Probe send time per address of the range
+        uint16_t                                           sequence{0};
+        std::vector<DiscoveredCamera>                      cameras;
+        std::vector<uint32_t>                              addresses; // Host byte order address of each camera
+        std::function<void(std::vector<DiscoveredCamera>)> done;
+    };
+
+    /**
+     * Find camera by id
+     * @return Camera or nullptr
+     */
+    Camera* camera(int cameraId);
+
+    /**
+     * Frame received bytes and dispatch them to the camera that sent them
+     * @param data Datagram or stream chunk
+     * @param length Data length
+     * @param ipv4Address Sender address in host byte order
+     * @param port Sender port
+     * @param receiveTime Kernel or read timestamp of the data
+     */
+    void processReceived(const uint8_t* data, size_t length, uint32_t ipv4Address, quint16 port, Transport::Clock::time_point receiveTime);
+
+    /**
+     * Find camera that sent a frame
+     * @return Camera or nullptr
+     */
+    Camera* findSource(uint32_t ipv4Address, quint16 port);
+
+    /**
+     * Parse frame and notify subscribers, then complete pending request
+     */
+    void dispatchFrame(Camera& source, const FrameView& frame, Transport::Clock::time_point receiveTime);
+
+    /**
+     * Queue frame in the outbound scheduler of camera and send what the rate limit allows
+     */
+    void scheduleFrame(Camera& destination, const uint8_t* data, size_t length);
+
+    /**
+     * Send due frames of the outbound scheduler, re-arms itself while frames wait for the rate limit
+     */
+    void drainOutbound(Camera& destination);
+
+    /**
+     * Send encoded frame to camera
+     */
+    void sendFrame(Camera& destination, const uint8_t* data, size_t length);
+
+    /**
+     * @return True if the transport is open and can send
+     */
+    [[nodiscard]] bool linkReady() const;
+
+    /**
+     * Send frames queued while the link was not ready, in order
+     */
+    void flushPending();
+
+    /**
+     * Decode and dispatch one received record of the running replay
+     */
+    void replayRecord(const capture::Record& record);
+
+    /**
+     * Report result of the running replay and release it
+     */
+    void finishReplay();
+
+    /**
+     * Collect hardware ID and firmware replies of the running discovery
+     * @return True if the datagram answers a probe
+     */
+    bool discoveryReceived(const uint8_t* data, size_t length, uint32_t ipv4Address, quint16 port,
+                           Transport::Clock::time_point receiveTime);
+
+    /**
+     * Report cameras of the running discovery and release it
+     */
+    void finishDiscovery();
+
+    /**
+     * Arm request timer for the earliest deadline of all cameras
      */
-    void addParser(ResponseMessageParser* parser);
+    void scheduleRequestTimer();
 
 private:
-    bool                                  _connected{false};
-    std::shared_ptr<MessageBuilder>       _messageBuilder;
-    QHostAddress                          _cameraAddress;
-    quint16                               _port;
-    QUdpSocket*                           _socket{nullptr};
-    QMap<Command, ResponseMessageParser*> _parsers;
+    bool                                 _connected{false};
+    TransportConfig                      _config;
+    std::unique_ptr<Transport>           _transport;
+    StreamFramer                         _framer; // Stream transports only
+    std::vector<std::unique_ptr<Camera>> _cameras;
+    int                                  _nextCameraId{0};
+    QTimer*                              _requestTimer{nullptr};
+    std::unique_ptr<CaptureRecorder>     _recorder;  // Set while capturing
+    std::unique_ptr<Replay>              _replay;    // Set while replaying
+    std::unique_ptr<Discovery>           _discovery; // Set while discovering
+    uint64_t                             _nextDiscoveryId{0};
 };
 
 } // namespace siyi
@@ -1,14 +1,33 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include <QByteArray>
 
+#include "Crc16.h"
+
 namespace siyi {
 
 class Crc {
 public:
+    using Kernel = crc::Kernel;
+
     [[nodiscard]] static uint16_t calculateCRC16(const QByteArray& data, uint16_t crc_init);
+
+    /**
+     * @brief Calculate CRC16 picking the fastest kernel for the data length
+     * @param data Data to checksum
+     * @param length Data length
+     * @param crc_init Initial CRC state, pass the result of a previous call to continue a checksum
+     * @return CRC16 state after processing the data
+     */
+    [[nodiscard]] static uint16_t calculateCRC16(const uint8_t* data, size_t length, uint16_t crc_init);
+
+    /**
+     * @brief Calculate CRC16 with the specified kernel
+     */
+    [[nodiscard]] static uint16_t calculateCRC16(const uint8_t* data, size_t length, uint16_t crc_init, Kernel kernel);
 };
 
 } // namespace siyi
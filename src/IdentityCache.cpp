@@ -0,0 +1,87 @@
+#include "IdentityCache.h"
+
+#include <algorithm>
+
+#include <QDir>
+#include <QLoggingCategory>
+#include <QSettings>
+#include <QStandardPaths>
+
+Q_LOGGING_CATEGORY(siyiSdkIdentityCache, "siyi.sdk.identitycache")
+
+namespace siyi {
+
+namespace {
+constexpr int kFormatVersion{1}; // Entries of other versions are ignored
+
+/**
+ * One group per camera, '/' would nest groups
+ */
+QString group(const QString& address, quint16 port) {
+    return QStringLiteral("%1:%2").arg(address).arg(port);
+}
+} // namespace
+
+IdentityCache::IdentityCache(const QString& path)
+    : _path(path) {}
+
+QString IdentityCache::defaultPath() {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)).filePath("siyisdk/identity.ini");
+}
+
+std::optional<CameraIdentity> IdentityCache::load(const QString& address, quint16 port) const {
+    QSettings settings(_path, QSettings::IniFormat);
+    settings.beginGroup(group(address, port));
+    if (settings.value("format").toInt() != kFormatVersion) {
+        return std::nullopt;
+    }
+
+    CameraIdentity identity;
+    const auto     hardwareID = QByteArray::fromHex(settings.value("hardwareId").toByteArray());
+    if (hardwareID.isEmpty() || static_cast<size_t>(hardwareID.size()) > identity.hardwareID.hardwareID.bytes.size()) {
+        qCWarning(siyiSdkIdentityCache) << "Ignoring unreadable entry of" << address << port;
+        return std::nullopt;
+    }
+    std::copy(hardwareID.begin(), hardwareID.end(), identity.hardwareID.hardwareID.bytes.begin());
+    identity.hardwareID.hardwareID.length   = static_cast<size_t>(hardwareID.size());
+    identity.hardwareID.modelId             = static_cast<uint16_t>(settings.value("modelId").toUInt());
+    identity.firmware.boardVersion          = settings.value("boardVersion").toUInt();
+    identity.firmware.gimbalFirmwareVersion = settings.value("gimbalFirmwareVersion").toUInt();
+    identity.firmware.zoomFirmwareVersion   = settings.value("zoomFirmwareVersion").toUInt();
+    identity.capabilities                   = settings.value("capabilities").toUInt();
+    return identity;
+}
+
+bool IdentityCache::store(const QString& address, quint16 port, const CameraIdentity& identity) {
+    const auto& hardwareID = identity.hardwareID.hardwareID;
+    if (hardwareID.size() == 0) {
+        return false;
+    }
+
+    const QByteArray bytes(reinterpret_cast<const char*>(hardwareID.data()), static_cast<int>(hardwareID.size()));
+
+    QSettings settings(_path, QSettings::IniFormat);
+    settings.beginGroup(group(address, port));
+    settings.setValue("format", kFormatVersion);
+    settings.setValue("hardwareId", bytes.toHex());
+    settings.setValue("modelId", identity.hardwareID.modelId);
+    settings.setValue("boardVersion", identity.firmware.boardVersion);
+    settings.setValue("gimbalFirmwareVersion", identity.firmware.gimbalFirmwareVersion);
+    settings.setValue("zoomFirmwareVersion", identity.firmware.zoomFirmwareVersion);
+    settings.setValue("capabilities", identity.capabilities);
+    settings.endGroup();
+    settings.sync();
+    if (settings.status() != QSettings::NoError) {
+        qCWarning(siyiSdkIdentityCache) << "Cannot write identity cache" << _path;
+        return false;
+    }
+    return true;
+}
+
+void IdentityCache::remove(const QString& address, quint16 port) {
+    QSettings settings(_path, QSettings::IniFormat);
+    settings.remove(group(address, port));
+    settings.sync();
+}
+
+} // namespace siyi
@@ -0,0 +1,144 @@
+#include "LinkMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace siyi {
+
+std::chrono::microseconds LatencyStats::percentile(double fraction) const {
+    if (count == 0) {
+        return std::chrono::microseconds(0);
+    }
+    const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count)));
+    uint64_t   seen = 0;
+    for (size_t index = 0; index < buckets.size(); ++index) {
+        seen += buckets[index];
+        if (seen >= std::max<uint64_t>(rank, 1)) {
+            return std::chrono::microseconds(static_cast<int64_t>(bucketLowerBound(index)));
+        }
+    }
+    return std::chrono::microseconds(static_cast<int64_t>(maxMicros));
+}
+
+LinkMetrics::LinkMetrics() = default;
+
+LinkMetrics::~LinkMetrics() {
+    for (auto& histogram : _histograms) {
+        delete histogram.load(std::memory_order_relaxed);
+    }
+}
+
+void LinkMetrics::frameSent(const uint8_t* frame, size_t length, Clock::time_point now) {
+    increment(_framesSent);
+    increment(_bytesSent, length);
+    if (length > FrameBuffer::kHeaderSize) {
+        const auto command    = frame[FrameBuffer::kHeaderSize - 1];
+        _sentAt[command]      = now;
+        _outstanding[command] = true;
+    }
+}
+
+void LinkMetrics::frameReceived(const FrameView& frame, Clock::time_point now) {
+    increment(_framesReceived);
+    increment(_bytesReceived, frame.frameSize);
+
+    const auto command = static_cast<uint8_t>(frame.command);
+    if (!_outstanding[command]) {
+        return;
+    }
+    _outstanding[command] = false;
+
+    auto* histogram = _histograms[command].load(std::memory_order_relaxed);
+    if (histogram == nullptr) {
+        histogram = new Histogram();
+        _histograms[command].store(histogram, std::memory_order_release);
+    }
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(now - _sentAt[command]).count();
+    histogram->record(static_cast<uint64_t>(std::max<int64_t>(micros, 0)));
+}
+
+void LinkMetrics::decodeFailed(DecodeError error, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    switch (error) {
+    case DecodeError::CrcMismatch:
+        increment(_crcErrors, count);
+        break;
+    case DecodeError::BadStx:
+        increment(_framingErrors, count);
+        break;
+    case DecodeError::TooShort:
+    case DecodeError::Truncated:
+        increment(_lengthErrors, count);
+        break;
+    case DecodeError::None:
+        break;
+    }
+}
+
+LinkStats LinkMetrics::snapshot() const {
+    LinkStats stats;
+    stats.framesSent      = _framesSent.load(std::memory_order_relaxed) + _directFramesSent.load(std::memory_order_relaxed);
+    stats.bytesSent       = _bytesSent.load(std::memory_order_relaxed) + _directBytesSent.load(std::memory_order_relaxed);
+    stats.framesReceived  = _framesReceived.load(std::memory_order_relaxed);
+    stats.bytesReceived   = _bytesReceived.load(std::memory_order_relaxed);
+    stats.crcErrors       = _crcErrors.load(std::memory_order_relaxed);
+    stats.lengthErrors    = _lengthErrors.load(std::memory_order_relaxed);
+    stats.framingErrors   = _framingErrors.load(std::memory_order_relaxed);
+    stats.unknownCommands = _unknownCommands.load(std::memory_order_relaxed);
+    stats.retransmissions = _retransmissions.load(std::memory_order_relaxed);
+    stats.requestTimeouts = _requestTimeouts.load(std::memory_order_relaxed);
+
+    stats.directSendFailures = _directSendFailures.load(std::memory_order_relaxed);
+
+    for (size_t priority = 0; priority < _outbound.size(); ++priority) {
+        const auto& counters = _outbound[priority];
+        auto&       queue    = stats.outbound[priority];
+        queue.depth          = counters.depth.load(std::memory_order_relaxed);
+        queue.maxDepth       = counters.maxDepth.load(std::memory_order_relaxed);
+        queue.sent           = counters.sent.load(std::memory_order_relaxed);
+        queue.staleDrops     = counters.staleDrops.load(std::memory_order_relaxed);
+        queue.overflowDrops  = counters.overflowDrops.load(std::memory_order_relaxed);
+    }
+
+    for (size_t command = 0; command < _histograms.size(); ++command) {
+        const auto* histogram = _histograms[command].load(std::memory_order_acquire);
+        if (histogram == nullptr) {
+            continue;
+        }
+        LatencyStats latency;
+        latency.command   = static_cast<Command>(command);
+        latency.count     = histogram->count.load(std::memory_order_relaxed);
+        latency.sumMicros = histogram->sumMicros.load(std::memory_order_relaxed);
+        latency.minMicros = latency.count == 0 ? 0 : histogram->minMicros.load(std::memory_order_relaxed);
+        latency.maxMicros = histogram->maxMicros.load(std::memory_order_relaxed);
+        for (size_t index = 0; index < latency.buckets.size(); ++index) {
+            latency.buckets[index] = histogram->buckets[index].load(std::memory_order_relaxed);
+        }
+        stats.latencies.push_back(latency);
+    }
+    return stats;
+}
+
+void LinkMetrics::outboundDepth(SendPriority priority, size_t depth) {
+    auto& counters = outbound(priority);
+    counters.depth.store(depth, std::memory_order_relaxed);
+    if (depth > counters.maxDepth.load(std::memory_order_relaxed)) {
+        counters.maxDepth.store(depth, std::memory_order_relaxed);
+    }
+}
+
+void LinkMetrics::Histogram::record(uint64_t micros) {
+    increment(buckets[LatencyStats::bucketIndex(micros)]);
+    increment(sumMicros, micros);
+    if (micros < minMicros.load(std::memory_order_relaxed)) {
+        minMicros.store(micros, std::memory_order_relaxed);
+    }
+    if (micros > maxMicros.load(std::memory_order_relaxed)) {
+        maxMicros.store(micros, std::memory_order_relaxed);
+    }
+    increment(count);
+}
+
+} // namespace siyi
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Frame.h"
+#include "LinkStats.h"
+
+namespace siyi {
+
+/**
+ * Link counters and per-command latency of one camera.
+ * Written by the communication thread only, so every update is a relaxed load and store without a locked
+ * instruction. snapshot() may be called from any thread, counters are read one by one.
+ * Latency is measured from the last request of a command to the next frame with the same command.
+ */
+class LinkMetrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LinkMetrics();
+    ~LinkMetrics();
+
+    LinkMetrics(const LinkMetrics&)            = delete;
+    LinkMetrics& operator=(const LinkMetrics&) = delete;
+
+    /**
+     * Count sent frame and start latency measurement of its command
+     * @param frame Encoded frame
+     * @param length Frame length
+     * @param now Send time
+     */
+    void frameSent(const uint8_t* frame, size_t length, Clock::time_point now);
+
+    /**
+     * Count received valid frame and complete latency measurement of its command
+     * @param frame Decoded frame
+     * @param now Receive time
+     */
+    void frameReceived(const FrameView& frame, Clock::time_point now);
+
+    /**
+     * Count frames rejected by the decoder
+     * @param error Decode error
+     * @param count Number of rejected frames
+     */
+    void decodeFailed(DecodeError error, uint64_t count = 1);
+
+    void unknownCommand() { increment(_unknownCommands); }
+    void payloadTooShort() { increment(_lengthErrors); }
+    void retransmission() { increment(_retransmissions); }
+    void requestTimeout() { increment(_requestTimeouts); }
+
+    /**
+     * Record depth of an outbound queue after a frame entered or left it
+     * @param priority Queue
+     * @param depth Frames waiting
+     */
+    void outboundDepth(SendPriority priority, size_t depth);
+
+    void outboundSent(SendPriority priority) { increment(outbound(priority).sent); }
+    void outboundStale(SendPriority priority, uint64_t count = 1) { increment(outbound(priority).staleDrops, count); }
+    void outboundOverflow(SendPriority priority) { increment(outbound(priority).overflowDrops); }
+
+    /**
+     * Count frame sent by a RealtimeSender, safe to call from any thread
+     * @param length Frame length
+     */
+    void directFrameSent(size_t length) {
+        _directFramesSent.fetch_add(1, std::memory_order_relaxed);
+        _directBytesSent.fetch_add(length, std::memory_order_relaxed);
+    }
+
+    /**
+     * Count frame a RealtimeSender could not send, safe to call from any thread
+     */
+    void directSendFailed() { _directSendFailures.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @return Copy of all counters and histograms, safe to call from any thread
+     */
+    [[nodiscard]] LinkStats snapshot() const;
+
+private:
+    /**
+     * Atomic mirror of LatencyStats
+     */
+    struct Histogram {
+        void record(uint64_t micros);
+
+        std::atomic<uint64_t>                                     count{0};
+        std::atomic<uint64_t>                                     sumMicros{0};
+        std::atomic<uint64_t>                                     minMicros{UINT64_MAX};
+        std::atomic<uint64_t>                                     maxMicros{0};
+        std::array<std::atomic<uint64_t>, LatencyStats::kBuckets> buckets{};
+    };
+
+    /**
+     * Atomic mirror of OutboundQueueStats
+     */
+    struct OutboundCounters {
+        std::atomic<uint64_t> depth{0};
+        std::atomic<uint64_t> maxDepth{0};
+        std::atomic<uint64_t> sent{0};
+        std::atomic<uint64_t> staleDrops{0};
+        std::atomic<uint64_t> overflowDrops{0};
+    };
+
+    OutboundCounters& outbound(SendPriority priority) { return _outbound[static_cast<size_t>(priority)]; }
+
+    /**
+     * Single writer increment
+     */
+    static void increment(std::atomic<uint64_t>& counter, uint64_t value = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> _framesSent{0};
+    std::atomic<uint64_t> _bytesSent{0};
+    std::atomic<uint64_t> _framesReceived{0};
+    std::atomic<uint64_t> _bytesReceived{0};
+    std::atomic<uint64_t> _crcErrors{0};
+    std::atomic<uint64_t> _lengthErrors{0};
+    std::atomic<uint64_t> _framingErrors{0};
+    std::atomic<uint64_t> _unknownCommands{0};
+    std::atomic<uint64_t> _retransmissions{0};
+    std::atomic<uint64_t> _requestTimeouts{0};
+
+    std::array<OutboundCounters, kSendPriorityCount> _outbound;
+
+    // Written by any number of RealtimeSender threads
+    std::atomic<uint64_t> _directFramesSent{0};
+    std::atomic<uint64_t> _directBytesSent{0};
+    std::atomic<uint64_t> _directSendFailures{0};
+
+    // Histograms are created on the first answer of a command and published to readers with release
+    std::array<std::atomic<Histogram*>, 256> _histograms{};
+
+    // Writer only
+    std::array<Clock::time_point, 256> _sentAt{};
+    std::array<bool, 256>              _outstanding{};
+};
+
+} // namespace siyi
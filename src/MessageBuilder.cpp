@@ -1,242 +1,239 @@
 #include "MessageBuilder.h"
 
-#include <QDataStream>
-#include <QIODevice>
 #include <QLoggingCategory>
-#include <QtEndian>
 
-#include "Crc.h"
+#include "Codec.h"
 
 Q_LOGGING_CATEGORY(siyiMessageBuilder, "siyi.messageBuilder")
 
 namespace siyi {
 
-uint16_t MessageBuilder::_sequenceNumber{0};
-
 QByteArray MessageBuilder::buildFirmwareRequestMessage() {
-    return encode(Command::ACQUIRE_FW_VER);
+    FrameBuffer frame;
+    buildFirmwareRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildHardwareIDRequestMessage() {
-    return encode(Command::ACQUIRE_HW_ID);
-}
-
-QByteArray MessageBuilder::buildAutoFocusRequestMessage() {
-    QByteArray data;
-    data.append(1);
-    return encode(Command::AUTO_FOCUS, data);
+    FrameBuffer frame;
+    buildHardwareIDRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildManualZoomRequestMessage(int8_t direction) {
-    if (direction > 1) {
-        direction = 1;
-    }
-    if (direction < -1) {
-        direction = -1;
-    }
-
-    QByteArray data;
-    data.append(direction);
-    return encode(Command::MANUAL_ZOOM, data);
+    FrameBuffer frame;
+    buildManualZoomRequestMessage(frame, direction);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildAbsoluteZoomRequestMessage(uint8_t zoomLevel) {
-    QByteArray data;
-    data.append(static_cast<char>(zoomLevel));
-    return encode(Command::ABSOLUTE_ZOOM, data);
+    FrameBuffer frame;
+    buildAbsoluteZoomRequestMessage(frame, zoomLevel);
+    return toByteArray(frame);
+}
+
+QByteArray MessageBuilder::buildAutoFocusRequestMessage() {
+    FrameBuffer frame;
+    buildAutoFocusRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildManualFocusShotRequestMessage(int8_t direction) {
-    if (direction > 1) {
-        direction = 1;
-    }
-    if (direction < -1) {
-        direction = -1;
-    }
-    QByteArray data;
-    data.append(direction);
-    return encode(Command::MANUAL_FOCUS, data);
+    FrameBuffer frame;
+    buildManualFocusShotRequestMessage(frame, direction);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildGimbalRotationRequestMessage(int8_t yawSpeed, int8_t pitchSpeed) {
-    QByteArray data;
-    data.append(yawSpeed);
-    data.append(pitchSpeed);
-    return encode(Command::GIMBAL_ROTATION, data);
+    FrameBuffer frame;
+    buildGimbalRotationRequestMessage(frame, yawSpeed, pitchSpeed);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildGimbalCenterRequestMessage() {
-    QByteArray data;
-    data.append(1);
-    return encode(Command::GIMBAL_CENTER, data);
+    FrameBuffer frame;
+    buildGimbalCenterRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildSetGimbalControlAngleRequestMessage(int16_t yawAngle, int16_t pitchAngle) {
-    QByteArray  data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-    stream << yawAngle;
-    stream << pitchAngle;
-    return encode(Command::GIMBAL_CONTROL_ANGLE, data);
+    FrameBuffer frame;
+    buildSetGimbalControlAngleRequestMessage(frame, yawAngle, pitchAngle);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildAcquireGimbalAttitudeRequestMessage() {
-    return encode(Command::ACQUIRE_GIMBAL_ATT);
+    FrameBuffer frame;
+    buildAcquireGimbalAttitudeRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildTakePhotoRequestMessage() {
-    QByteArray data;
-    data.append(static_cast<char>(0));
-    return encode(Command::PHOTO_VIDEO_HDR, data);
+    FrameBuffer frame;
+    buildTakePhotoRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildSwitchHDRRequestMessage() {
-    QByteArray data;
-    data.append(1);
-    return encode(Command::PHOTO_VIDEO_HDR, data);
+    FrameBuffer frame;
+    buildSwitchHDRRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildStartStopRecordingRequestMessage() {
-    QByteArray data;
-    data.append(2);
-    return encode(Command::PHOTO_VIDEO_HDR, data);
+    FrameBuffer frame;
+    buildStartStopRecordingRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildMotionLockModeRequestMessage() {
-    QByteArray data;
-    data.append(3);
-    return encode(Command::PHOTO_VIDEO_HDR, data);
+    FrameBuffer frame;
+    buildMotionLockModeRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildMotionFollowModeRequestMessage() {
-    QByteArray data;
-    data.append(4);
-    return encode(Command::PHOTO_VIDEO_HDR, data);
+    FrameBuffer frame;
+    buildMotionFollowModeRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildMotionFPVModeRequestMessage() {
-    QByteArray data;
-    data.append(5);
-    return encode(Command::PHOTO_VIDEO_HDR, data);
+    FrameBuffer frame;
+    buildMotionFPVModeRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildSetVideoOutputHDMIRequestMessage() {
-    QByteArray data;
-    data.append(6);
-    return encode(Command::PHOTO_VIDEO_HDR, data);
+    FrameBuffer frame;
+    buildSetVideoOutputHDMIRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildSetVideoOutputCVBSRequestMessage() {
-    QByteArray data;
-    data.append(7);
-    return encode(Command::PHOTO_VIDEO_HDR, data);
+    FrameBuffer frame;
+    buildSetVideoOutputCVBSRequestMessage(frame);
+    return toByteArray(frame);
 }
 
 QByteArray MessageBuilder::buildAcquireGimbalInfoRequestMessage() {
-    return encode(Command::ACQUIRE_GIMBAL_INFO);
+    FrameBuffer frame;
+    buildAcquireGimbalInfoRequestMessage(frame);
+    return toByteArray(frame);
 }
 
-std::tuple<QByteArray, size_t, Command, uint16_t> MessageBuilder::decode(const QByteArray& message) {
-    // Assuming the message structure is: header (2 bytes), control (1 byte),
-    // data length (2 bytes), sequence number (2 bytes), command code (1 byte), data, CRC (2 bytes)
+QByteArray MessageBuilder::buildDataStreamRequestMessage(DataStreamType type, DataStreamFrequency frequency) {
+    FrameBuffer frame;
+    buildDataStreamRequestMessage(frame, type, frequency);
+    return toByteArray(frame);
+}
 
-    // Check if the message has at least the minimum required length
-    if (message.size() < 10) {
-        // Handle error, the message is too short
-        // You can throw an exception or return an error tuple indicating the failure
-        // For simplicity, let's assume an empty data and zero values for other fields
-        return std::make_tuple(QByteArray(), 0, Command::UNKNOWN, 0);
-    }
+void MessageBuilder::buildFirmwareRequestMessage(FrameBuffer& frame) {
+    _encoder.buildFirmwareRequestMessage(frame);
+}
 
-    // Extract the header (revert the byte order) skip
+void MessageBuilder::buildHardwareIDRequestMessage(FrameBuffer& frame) {
+    _encoder.buildHardwareIDRequestMessage(frame);
+}
 
-    // Extract the control and data length
-    auto control    = static_cast<uint8_t>(extractByte(message, 2));
-    auto dataLength = static_cast<uint16_t>((static_cast<uint16_t>(extractByte(message, 4)) << 8)
-                                            | static_cast<uint16_t>(extractByte(message, 3)));
+void MessageBuilder::buildAutoFocusRequestMessage(FrameBuffer& frame) {
+    _encoder.buildAutoFocusRequestMessage(frame);
+}
 
-    // Check message length
-    if (dataLength >= message.size() - 5) {
-        qCWarning(siyiMessageBuilder) << "Message length is not correct";
-        return std::make_tuple(QByteArray(), 0, Command::UNKNOWN, 0);
-    }
+void MessageBuilder::buildManualZoomRequestMessage(FrameBuffer& frame, int8_t direction) {
+    _encoder.buildManualZoomRequestMessage(frame, direction);
+}
+
+void MessageBuilder::buildAbsoluteZoomRequestMessage(FrameBuffer& frame, uint8_t zoomLevel) {
+    _encoder.buildAbsoluteZoomRequestMessage(frame, zoomLevel);
+}
+
+void MessageBuilder::buildManualFocusShotRequestMessage(FrameBuffer& frame, int8_t direction) {
+    _encoder.buildManualFocusShotRequestMessage(frame, direction);
+}
 
-    // Extract the sequence number (revert the byte order)
-    auto sequenceNumber = static_cast<uint16_t>((static_cast<uint16_t>(extractByte(message, 6)) << 8)
-                                                | static_cast<uint16_t>(extractByte(message, 5)));
+void MessageBuilder::buildGimbalRotationRequestMessage(FrameBuffer& frame, int8_t yawSpeed, int8_t pitchSpeed) {
+    _encoder.buildGimbalRotationRequestMessage(frame, yawSpeed, pitchSpeed);
+}
 
-    // Extract the command code
-    auto commandCode = static_cast<uint8_t>(extractByte(message, 7));
+void MessageBuilder::buildGimbalCenterRequestMessage(FrameBuffer& frame) {
+    _encoder.buildGimbalCenterRequestMessage(frame);
+}
 
-    // Extract the data
-    QByteArray data = message.mid(8, dataLength);
+void MessageBuilder::buildSetGimbalControlAngleRequestMessage(FrameBuffer& frame, int16_t yawAngle, int16_t pitchAngle) {
+    _encoder.buildSetGimbalControlAngleRequestMessage(frame, yawAngle, pitchAngle);
+}
 
-    // Extract the CRC (revert the byte order)
-    auto receivedCRC = static_cast<uint16_t>((static_cast<uint16_t>(extractByte(message, message.length() - 1)) << 8)
-                                             | static_cast<uint16_t>(extractByte(message, message.length() - 2)));
+void MessageBuilder::buildAcquireGimbalAttitudeRequestMessage(FrameBuffer& frame) {
+    _encoder.buildAcquireGimbalAttitudeRequestMessage(frame);
+}
 
-    // Calculate the CRC for the message (excluding the CRC itself)
-    uint16_t calculatedCRC = Crc::calculateCRC16(message.mid(0, message.length() - 2), 0);
+void MessageBuilder::buildTakePhotoRequestMessage(FrameBuffer& frame) {
+    _encoder.buildTakePhotoRequestMessage(frame);
+}
 
-    // Check if the received CRC matches the calculated CRC
-    if (receivedCRC != calculatedCRC) {
-        qCDebug(siyiMessageBuilder) << "CRC error";
-        // Handle CRC error, the received CRC does not match the calculated CRC
-        // You can throw an exception or return an error tuple indicating the failure
-        // For simplicity, let's assume an empty data and zero values for other fields
-        return std::make_tuple(QByteArray(), 0, Command::UNKNOWN, 0);
-    }
+void MessageBuilder::buildSwitchHDRRequestMessage(FrameBuffer& frame) {
+    _encoder.buildSwitchHDRRequestMessage(frame);
+}
 
-    // Create the tuple with the extracted values and return it
-    return std::make_tuple(data, dataLength, static_cast<Command>(commandCode), sequenceNumber);
+void MessageBuilder::buildStartStopRecordingRequestMessage(FrameBuffer& frame) {
+    _encoder.buildStartStopRecordingRequestMessage(frame);
 }
 
-QByteArray MessageBuilder::encode(Command command, const QByteArray& data) {
-    uint16_t header         = revertBytes(0x6655);
-    uint8_t  control        = 0x01;
-    uint16_t dataLength     = revertBytes(data.length());
-    uint16_t sequenceNumber = revertBytes(getSequenceNumber());
-    uint8_t  commandCode    = static_cast<uint8_t>(command);
+void MessageBuilder::buildMotionLockModeRequestMessage(FrameBuffer& frame) {
+    _encoder.buildMotionLockModeRequestMessage(frame);
+}
 
-    QByteArray message;
-    message.append(reinterpret_cast<const char*>(&header), sizeof(header));
-    message.append(reinterpret_cast<const char*>(&control), sizeof(control));
-    message.append(reinterpret_cast<const char*>(&dataLength), sizeof(dataLength));
-    message.append(reinterpret_cast<const char*>(&sequenceNumber), sizeof(sequenceNumber));
-    message.append(reinterpret_cast<const char*>(&commandCode), sizeof(commandCode));
-    message.append(data);
+void MessageBuilder::buildMotionFollowModeRequestMessage(FrameBuffer& frame) {
+    _encoder.buildMotionFollowModeRequestMessage(frame);
+}
 
-    uint16_t crc         = Crc::calculateCRC16(message, 0);
-    uint16_t crcReversed = revertBytes(crc);
-    message.append(reinterpret_cast<const char*>(&crcReversed), sizeof(crcReversed));
+void MessageBuilder::buildMotionFPVModeRequestMessage(FrameBuffer& frame) {
+    _encoder.buildMotionFPVModeRequestMessage(frame);
+}
 
-    qCDebug(siyiMessageBuilder) << "MessageBuilder::encode: " << message.toHex();
+void MessageBuilder::buildSetVideoOutputHDMIRequestMessage(FrameBuffer& frame) {
+    _encoder.buildSetVideoOutputHDMIRequestMessage(frame);
+}
 
-    return message;
+void MessageBuilder::buildSetVideoOutputCVBSRequestMessage(FrameBuffer& frame) {
+    _encoder.buildSetVideoOutputCVBSRequestMessage(frame);
 }
 
-uint16_t MessageBuilder::getSequenceNumber() {
-    auto returnNumber = _sequenceNumber;
-    _sequenceNumber++;
-    if (_sequenceNumber > 65535) {
-        _sequenceNumber = 0;
-    }
+void MessageBuilder::buildAcquireGimbalInfoRequestMessage(FrameBuffer& frame) {
+    _encoder.buildAcquireGimbalInfoRequestMessage(frame);
+}
 
-    return returnNumber;
+void MessageBuilder::buildDataStreamRequestMessage(FrameBuffer& frame, DataStreamType type, DataStreamFrequency frequency) {
+    _encoder.buildDataStreamRequestMessage(frame, type, frequency);
 }
 
-uint16_t MessageBuilder::revertBytes(uint16_t value) {
-    // Convert ToLittleEndian only if needed
-    if (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
-        return qToLittleEndian(value);
+FrameView MessageBuilder::decode(const uint8_t* data, size_t length) {
+    const auto frame = decodeFrame(data, length);
+    if (frame.error == DecodeError::Truncated) {
+        qCWarning(siyiMessageBuilder) << "Message length is not correct";
+    } else if (frame.error == DecodeError::CrcMismatch) {
+        qCDebug(siyiMessageBuilder) << "CRC error";
     }
-    return value;
+    return frame;
 }
 
-uint8_t MessageBuilder::extractByte(const QByteArray& data, size_t index) {
-    if (data.size() > index) {
-        return static_cast<uint8_t>(data[static_cast<int>(index)]);
+FrameView MessageBuilder::decode(const QByteArray& message) {
+    return decode(reinterpret_cast<const uint8_t*>(message.constData()), static_cast<size_t>(message.size()));
+}
+
+bool MessageBuilder::encode(FrameBuffer& frame, Command command, const uint8_t* data, size_t dataLength) {
+    if (!_encoder.encode(frame, command, data, dataLength)) {
+        qCWarning(siyiMessageBuilder) << "Payload does not fit into frame buffer:" << dataLength;
+        return false;
     }
-    return 0;
+    return true;
+}
+
+QByteArray MessageBuilder::toByteArray(const FrameBuffer& frame) {
+    QByteArray message(reinterpret_cast<const char*>(frame.data()), static_cast<int>(frame.size()));
+    qCDebug(siyiMessageBuilder) << "MessageBuilder::encode: " << message.toHex();
+    return message;
 }
 
 } // namespace siyi
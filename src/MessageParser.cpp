@@ -1,154 +1,71 @@
 #include "MessageParser.h"
 
-#include <QDataStream>
+#include <algorithm>
+
 #include <QLoggingCategory>
 
-#include "Message.h"
+#include "MessageDispatch.h"
 
 Q_LOGGING_CATEGORY(siyiMessageParser, "siyi.messageParser")
 
 namespace siyi {
 
-QVariant FirmwareMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing firmware message " << data.toHex();
-
-    FirmwareMessage firmwareMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> firmwareMessage.boardVersion;
-    stream >> firmwareMessage.gimbalFirmwareVersion;
-    stream >> firmwareMessage.zoomFirmwareVersion;
-    return QVariant::fromValue(firmwareMessage);
-}
-
-QVariant HardwareIDMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing hardware ID message " << data.toHex();
-
-    HardwareIDMessage hardwareIDMessage;
-    hardwareIDMessage.hardwareID = data.toHex();
-
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> hardwareIDMessage.modelId;
-
-    return QVariant::fromValue(hardwareIDMessage);
-}
-
-QVariant AutoFocusMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing auto focus message " << data.toHex();
-
-    AutoFocusMessage autoFocusMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> autoFocusMessage.success;
-    return QVariant::fromValue(autoFocusMessage);
-}
-
-QVariant ManualZoomMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing manual zoom message " << data.toHex();
-
-    ManualZoomMessage manualZoomMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> manualZoomMessage.zoomLevel;
-    return QVariant::fromValue(manualZoomMessage);
-}
-
-QVariant AbsoluteZoomMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing absolute zoom message " << data.toHex();
-
-    AbsoluteZoomMessage absoluteZoomMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> absoluteZoomMessage.absoluteMovementAsk;
-    return QVariant::fromValue(absoluteZoomMessage);
-}
-
-QVariant ManualFocusMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing manual focus message " << data.toHex();
-
-    ManualFocusMessage manualFocusMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> manualFocusMessage.state;
-    return QVariant::fromValue(manualFocusMessage);
-}
-
-QVariant GimbalRotationMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing gimbal rotation message " << data.toHex();
-
-    GimbalRotationMessage gimbalRotationMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> gimbalRotationMessage.state;
-    return QVariant::fromValue(gimbalRotationMessage);
+MessageParser::MessageParser() {
+    addParser<FirmwareMessage, &MessageHandler::onFirmware>();
+    addParser<HardwareIDMessage, &MessageHandler::onHardwareID>();
+    addParser<AutoFocusMessage, &MessageHandler::onAutoFocus>();
+    addParser<ManualZoomMessage, &MessageHandler::onManualZoom>();
+    addParser<AbsoluteZoomMessage, &MessageHandler::onAbsoluteZoom>();
+    addParser<ManualFocusMessage, &MessageHandler::onManualFocus>();
+    addParser<GimbalRotationMessage, &MessageHandler::onGimbalRotation>();
+    addParser<GimbalCenterMessage, &MessageHandler::onGimbalCenter>();
+    addParser<FunctionFeedbackMessage, &MessageHandler::onFunctionFeedback>();
+    addParser<GimbalAttitudeMessage, &MessageHandler::onGimbalAttitude>();
+    addParser<GimbalControlAngleMessage, &MessageHandler::onGimbalControlAngle>();
+    addParser<CameraStatusInfoMessage, &MessageHandler::onCameraStatusInfo>();
+    addParser<DataStreamMessage, &MessageHandler::onDataStream>();
 }
 
-QVariant GimbalCenterMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing gimbal center message " << data.toHex();
-
-    GimbalCenterMessage gimbalCenterMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> gimbalCenterMessage.state;
-    return QVariant::fromValue(gimbalCenterMessage);
+void MessageParser::addHandler(MessageHandler* handler) {
+    if (handler != nullptr && std::find(_handlers.begin(), _handlers.end(), handler) == _handlers.end()) {
+        _handlers.push_back(handler);
+    }
 }
 
-QVariant FunctionFeedbackMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing function feedback message " << data.toHex();
-
-    FunctionFeedbackMessage functionFeedbackMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> functionFeedbackMessage.state;
-    return QVariant::fromValue(functionFeedbackMessage);
+void MessageParser::removeHandler(MessageHandler* handler) {
+    _handlers.erase(std::remove(_handlers.begin(), _handlers.end(), handler), _handlers.end());
 }
 
-QVariant GimbalAttitudeMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing gimbal attitude message " << data.toHex();
-
-    GimbalAttitudeMessage gimbalAttitudeMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> gimbalAttitudeMessage.pitch;
-    stream >> gimbalAttitudeMessage.roll;
-    stream >> gimbalAttitudeMessage.yaw;
-    return QVariant::fromValue(gimbalAttitudeMessage);
+bool MessageParser::parse(const FrameView& frame, std::chrono::steady_clock::time_point receiveTime) const {
+    const auto parser = _parsers[static_cast<uint8_t>(frame.command)];
+    if (parser == nullptr) {
+        qCWarning(siyiMessageParser) << "No parser for command" << static_cast<int>(frame.command);
+        return false;
+    }
+    ReceiveInfo info;
+    info.receiveTime    = receiveTime;
+    info.sequenceNumber = frame.sequenceNumber;
+    return parser(frame, info, _handlers);
 }
 
-QVariant GimbalControlAngleMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing gimbal control angle message " << data.toHex();
-
-    GimbalControlAngleMessage gimbalControlAngleMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    stream >> gimbalControlAngleMessage.pitch;
-    stream >> gimbalControlAngleMessage.roll;
-    stream >> gimbalControlAngleMessage.yaw;
-    return QVariant::fromValue(gimbalControlAngleMessage);
+template<typename Message, void (MessageHandler::*Callback)(const Message&)>
+bool MessageParser::parseAndDispatch(const FrameView& frame, const ReceiveInfo& info, const Handlers& handlers) {
+    Message message;
+    if (!parseMessage(frame, message)) {
+        qCWarning(siyiMessageParser) << "Payload too short for command" << static_cast<int>(frame.command) << "length"
+                                     << frame.dataLength;
+        return false;
+    }
+    for (auto* handler : handlers) {
+        handler->_receiveInfo = info;
+        (handler->*Callback)(message);
+    }
+    return true;
 }
 
-QVariant CameraStatusInfoMessageParser::parse(const QByteArray& data) const {
-    qCDebug(siyiMessageParser) << "Parsing camera status info message " << data.toHex();
-
-    CameraStatusInfoMessage cameraStatusInfoMessage;
-    // Read the data from the stream into the struct fields
-    QDataStream stream(data);
-    uint8_t     status;
-    stream >> status; // reserved
-    stream >> status; // hdr status
-    cameraStatusInfoMessage.hdrOn = status == 1;
-    stream >> status; // reserved
-    stream >> status; // recording status
-    cameraStatusInfoMessage.recordingStatus = static_cast<CameraStatusInfoMessage::RecordingStatus>(status);
-    stream >> status; // gimbal motion mode
-    cameraStatusInfoMessage.gimbalMotionMode = static_cast<CameraStatusInfoMessage::GimbalMotionMode>(status);
-    stream >> status; // gimbal mounting
-    cameraStatusInfoMessage.gimbalMounting = static_cast<CameraStatusInfoMessage::GimbalMounting>(status);
-    stream >> status; // hdmi on cvbs off
-    cameraStatusInfoMessage.hdmiOnCvbsOff = status == 0;
-
-    return QVariant::fromValue(cameraStatusInfoMessage);
+template<typename Message, void (MessageHandler::*Callback)(const Message&)>
+void MessageParser::addParser() {
+    _parsers[static_cast<uint8_t>(Message::kCommand)] = &MessageParser::parseAndDispatch<Message, Callback>;
 }
 
 } // namespace siyi
@@ -1,128 +1,69 @@
 #pragma once
 
-#include <QByteArray>
-#include <QVariant>
+#include <array>
+#include <chrono>
+#include <vector>
 
 #include "Command.h"
+#include "Frame.h"
+#include "MessageHandler.h"
 
 namespace siyi {
 
 /**
- * Response message
+ * Parses received frames and dispatches typed messages to subscribers.
+ * Parsers are looked up in a table indexed directly by the command byte.
  */
-struct ResponseMessageParser {
-    virtual ~ResponseMessageParser() = default;
+class MessageParser {
+public:
+    MessageParser();
+
     /**
-     * Parse message
-     * @param data
+     * Add subscriber, it must outlive the parser or be removed first
+     * @param handler Subscriber
      */
-    [[nodiscard]] virtual QVariant parse(const QByteArray& data) const = 0;
-    [[nodiscard]] virtual Command  command() const                     = 0;
-
-    bool success{false};
-};
-
-/**
- * The FirmwareMessage
- */
-struct FirmwareMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::ACQUIRE_FW_VER; }
-};
-
-/**
- * The HardwareIDMessage
- */
-struct HardwareIDMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::ACQUIRE_HW_ID; }
-};
-
-/**
- * The AutoFocusMessage
- */
-struct AutoFocusMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::AUTO_FOCUS; }
-};
-
-/**
- * The ManualZoomMessage
- */
-struct ManualZoomMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::MANUAL_ZOOM; }
-};
-
-/**
- * The AbsoluteZoomMessage
- */
-struct AbsoluteZoomMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::ABSOLUTE_ZOOM; }
-};
-
-/**
- * The ManualFocusMessage
- */
-struct ManualFocusMessageParser : public ResponseMessageParser {
-    QVariant              parse(const QByteArray& data) const override;
-    [[nodiscard]] Command command() const override { return Command::MANUAL_FOCUS; }
-};
+    void addHandler(MessageHandler* handler);
 
-/**
- * The GimbalRotationMessage
- */
-struct GimbalRotationMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::GIMBAL_ROTATION; }
-};
-
-/**
- * The CenterMessage
- */
+    /**
+     * Remove subscriber
+     * @param handler Subscriber
+     */
+    void removeHandler(MessageHandler* handler);
 
-struct GimbalCenterMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::GIMBAL_CENTER; }
-};
+    /**
+     * Check if parser for command is available
+     * @param command Command
+     * @return True if parser is available
+     */
+    [[nodiscard]] bool hasParser(Command command) const { return _parsers[static_cast<uint8_t>(command)] != nullptr; }
 
-/**
- * The FunctionFeedbackMessage
- */
-struct FunctionFeedbackMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::FUNC_FEEDBACK_INFO; }
+    /**
+     * Parse frame and notify subscribers
+     * @param frame Decoded frame, the payload is not copied
+     * @param receiveTime Arrival of the frame, available to subscribers through MessageHandler::receiveInfo()
+     * @return True if message was parsed and dispatched
+     */
+    bool parse(const FrameView& frame, std::chrono::steady_clock::time_point receiveTime) const;
 
-    // 0: Success
-    // 1: Fail to take a photo (Please check
-    // if TF card is inserted)
-    // 2: HDR ON
-    // 3: HDR OFF
-    // 4: Fail to record a video (Please check
-    // if TF card is inserted)
-    uint8_t state{0};
-};
+private:
+    using Handlers      = std::vector<MessageHandler*>;
+    using ParseFunction = bool (*)(const FrameView& frame, const ReceiveInfo& info, const Handlers& handlers);
 
-/**
- * The GimbalAttitudeMessage
- */
-struct GimbalAttitudeMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::ACQUIRE_GIMBAL_ATT; }
-};
+    /**
+     * Parse payload according to Message::Layout and invoke Callback on every subscriber
+     */
+    template<typename Message, void (MessageHandler::*Callback)(const Message&)>
+    static bool parseAndDispatch(const FrameView& frame, const ReceiveInfo& info, const Handlers& handlers);
 
-/**
- * The GimbalControlAngleMessage
- */
-struct GimbalControlAngleMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::GIMBAL_CONTROL_ANGLE; }
-};
+    /**
+     * Register parser for Message::kCommand
+     */
+    template<typename Message, void (MessageHandler::*Callback)(const Message&)>
+    void addParser();
 
-struct CameraStatusInfoMessageParser : public ResponseMessageParser {
-    [[nodiscard]] QVariant parse(const QByteArray& data) const override;
-    [[nodiscard]] Command  command() const override { return Command::ACQUIRE_GIMBAL_INFO; }
+private:
+    std::array<ParseFunction, 256> _parsers{};
+    Handlers                       _handlers;
 };
 
 } // namespace siyi
@@ -0,0 +1,96 @@
+#include "OutboundScheduler.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "FrameTemplate.h"
+
+namespace siyi {
+
+namespace {
+constexpr size_t kCommandOffset = FrameTemplate::kSequenceOffset + 2;
+} // namespace
+
+OutboundScheduler::OutboundScheduler(LinkMetrics& metrics)
+    : _metrics(metrics) {
+    for (auto& queue : _queues) {
+        queue.reserve(kMaxQueueDepth);
+    }
+    setMaxFrameRate(kDefaultMaxFrameRate);
+}
+
+bool OutboundScheduler::sameRequest(const uint8_t* lhs, size_t lhsLength, const uint8_t* rhs, size_t rhsLength) {
+    constexpr size_t kSequenceOffset = FrameTemplate::kSequenceOffset;
+    constexpr size_t kCrcSize        = FrameBuffer::kCrcSize;
+    if (lhsLength != rhsLength || lhsLength < FrameBuffer::kHeaderSize + kCrcSize) {
+        return false;
+    }
+    return std::memcmp(lhs, rhs, kSequenceOffset) == 0
+           && std::memcmp(lhs + kCommandOffset, rhs + kCommandOffset, lhsLength - kCommandOffset - kCrcSize) == 0;
+}
+
+bool OutboundScheduler::enqueue(const uint8_t* data, size_t length, Clock::time_point now) {
+    if (length > FrameBuffer::kCapacity || length <= kCommandOffset) {
+        return false;
+    }
+    const auto priority = OutboundScheduler::priority(static_cast<Command>(data[kCommandOffset]));
+    auto&      queue    = _queues[static_cast<size_t>(priority)];
+    dropStale(priority, now);
+
+    // The newer poll moves to the back, so deadlines keep growing along the queue
+    if (priority == SendPriority::Background) {
+        const auto same = std::find_if(queue.begin(), queue.end(), [data, length](const Entry& entry) {
+            return sameRequest(entry.frame.data(), entry.frame.size(), data, length);
+        });
+        if (same != queue.end()) {
+            queue.erase(same);
+            _metrics.outboundStale(priority);
+        }
+    }
+    if (queue.size() >= kMaxQueueDepth) {
+        _metrics.outboundOverflow(priority);
+        return false;
+    }
+
+    Entry entry;
+    std::copy(data, data + length, entry.frame.bytes.begin());
+    entry.frame.length = length;
+    entry.deadline     = now + maxAge(priority);
+    queue.push_back(entry);
+    _metrics.outboundDepth(priority, queue.size());
+    return true;
+}
+
+void OutboundScheduler::setMaxFrameRate(double rateHz) {
+    _interval = rateHz > 0 ? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / rateHz)) : std::chrono::nanoseconds(0);
+}
+
+size_t OutboundScheduler::size() const {
+    size_t size = 0;
+    for (const auto& queue : _queues) {
+        size += queue.size();
+    }
+    return size;
+}
+
+void OutboundScheduler::refill(Clock::time_point now) {
+    if (_interval.count() <= 0 || now <= _refilled) {
+        return;
+    }
+    const auto elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - _refilled).count());
+    _tokens            = std::min(kBurst, _tokens + elapsed / static_cast<double>(_interval.count()));
+    _refilled          = now;
+}
+
+void OutboundScheduler::dropStale(SendPriority priority, Clock::time_point now) {
+    auto&      queue = _queues[static_cast<size_t>(priority)];
+    const auto fresh = std::find_if(queue.begin(), queue.end(), [now](const Entry& entry) { return entry.deadline >= now; });
+    if (fresh == queue.begin()) {
+        return;
+    }
+    _metrics.outboundStale(priority, static_cast<uint64_t>(fresh - queue.begin()));
+    queue.erase(queue.begin(), fresh);
+    _metrics.outboundDepth(priority, queue.size());
+}
+
+} // namespace siyi
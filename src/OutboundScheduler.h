@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Command.h"
+#include "Frame.h"
+#include "LinkMetrics.h"
+#include "LinkStats.h"
+
+namespace siyi {
+
+/**
+ * Outbound stage of one camera between the API and the transport.
+ * Frames wait in one FIFO per SendPriority and leave highest class first, no faster than the frame rate the
+ * gimbal MCU can process. Every frame gets a deadline from its class; a frame still waiting past it is dropped
+ * instead of being sent late. A waiting poll is replaced by an identical newer one. Frames are sent at once
+ * while the rate allows, so the stage only adds latency under load.
+ * Not thread safe, used on the communication thread only.
+ */
+class OutboundScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // The gimbal MCU reads a 115200 baud UART, about 900 short frames per second; half is left for its replies
+    static constexpr double kDefaultMaxFrameRate{400.0};
+    static constexpr double kBurst{8.0};        // Frames sent back to back after an idle period
+    static constexpr size_t kMaxQueueDepth{64}; // Frames per class
+
+    /**
+     * @param metrics Queue counters of the camera
+     */
+    explicit OutboundScheduler(LinkMetrics& metrics);
+
+    /**
+     * @param command Command of a frame
+     * @return Priority class of the command
+     */
+    static constexpr SendPriority priority(Command command) {
+        switch (command) {
+        case Command::GIMBAL_ROTATION:
+        case Command::GIMBAL_CONTROL_ANGLE:
+        case Command::GIMBAL_CENTER:
+            return SendPriority::Control;
+        case Command::ACQUIRE_FW_VER:
+        case Command::ACQUIRE_HW_ID:
+        case Command::ACQUIRE_GIMBAL_INFO:
+        case Command::ACQUIRE_GIMBAL_ATT:
+            return SendPriority::Background;
+        default:
+            return SendPriority::Action;
+        }
+    }
+
+    /**
+     * @param priority Priority class
+     * @return Time a frame of the class may wait before it is dropped
+     */
+    static constexpr std::chrono::milliseconds maxAge(SendPriority priority) {
+        switch (priority) {
+        case SendPriority::Control:
+            return std::chrono::milliseconds(50); // A late motion command moves the gimbal to an outdated target
+        case SendPriority::Action:
+            return std::chrono::milliseconds(1000);
+        case SendPriority::Background:
+        default:
+            return std::chrono::milliseconds(100); // Attitude poll period, the next poll is due
+        }
+    }
+
+    /**
+     * @brief Check if two encoded frames are equal apart from sequence number and CRC
+     */
+    static bool sameRequest(const uint8_t* lhs, size_t lhsLength, const uint8_t* rhs, size_t rhsLength);
+
+    /**
+     * Queue frame
+     * @param data Encoded frame
+     * @param length Frame length
+     * @param now Current time, the deadline of the frame counts from it
+     * @return False if the frame was dropped because it is too long or its queue is full
+     */
+    bool enqueue(const uint8_t* data, size_t length, Clock::time_point now);
+
+    /**
+     * Send waiting frames, highest class first, while the rate limit allows, dropping frames past their deadline
+     * @param now Current time
+     * @param send Sends one frame
+     * @return Time until the next frame may be sent, empty if nothing is waiting
+     */
+    template<typename Send>
+    std::optional<std::chrono::nanoseconds> drain(Clock::time_point now, Send&& send);
+
+    /**
+     * Limit frame rate of the camera
+     * @param rateHz Maximum frames per second, 0 or less disables the limit
+     */
+    void setMaxFrameRate(double rateHz);
+
+    /**
+     * @return Frames waiting in all classes
+     */
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct Entry {
+        FrameBuffer       frame;
+        Clock::time_point deadline;
+    };
+
+    /**
+     * Add tokens for the time since the last refill, up to kBurst
+     */
+    void refill(Clock::time_point now);
+
+    /**
+     * Drop frames past their deadline. Deadlines grow from the front to the back of a queue.
+     */
+    void dropStale(SendPriority priority, Clock::time_point now);
+
+private:
+    LinkMetrics&                                       _metrics;
+    std::array<std::vector<Entry>, kSendPriorityCount> _queues;      // Reserved to kMaxQueueDepth, front is the oldest
+    std::chrono::nanoseconds                           _interval{0}; // Between two frames at the maximum rate, 0 without limit
+    double                                             _tokens{kBurst};
+    Clock::time_point                                  _refilled{};
+};
+
+template<typename Send>
+std::optional<std::chrono::nanoseconds> OutboundScheduler::drain(Clock::time_point now, Send&& send) {
+    refill(now);
+    for (size_t index = 0; index < _queues.size();) {
+        const auto priority = static_cast<SendPriority>(index);
+        auto&      queue    = _queues[index];
+        dropStale(priority, now);
+        if (queue.empty()) {
+            ++index;
+            continue;
+        }
+        if (_interval.count() > 0) {
+            if (_tokens < 1.0) {
+                return std::chrono::nanoseconds(static_cast<int64_t>((1.0 - _tokens) * static_cast<double>(_interval.count())));
+            }
+            _tokens -= 1.0;
+        }
+        const auto frame = queue.front().frame;
+        queue.erase(queue.begin());
+        _metrics.outboundDepth(priority, queue.size());
+        _metrics.outboundSent(priority);
+        send(frame);
+    }
+    return std::nullopt;
+}
+
+} // namespace siyi
@@ -0,0 +1,70 @@
+#include "RealtimeSender.h"
+
+#include <QtGlobal>
+
+#ifdef Q_OS_UNIX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include "LinkMetrics.h"
+#include "MessageBuilder.h"
+
+namespace siyi {
+
+RealtimeSender::RealtimeSender(std::shared_ptr<MessageBuilder> messageBuilder, std::shared_ptr<LinkMetrics> metrics, intptr_t descriptor,
+                               uint32_t ipv4Address, uint16_t port)
+    : _messageBuilder(std::move(messageBuilder))
+    , _metrics(std::move(metrics))
+    , _descriptor(descriptor)
+    , _ipv4Address(ipv4Address)
+    , _port(port) {}
+
+RealtimeSender::~RealtimeSender() = default;
+
+bool RealtimeSender::setAngles(float pan, float tilt) {
+    FrameBuffer frame;
+    _messageBuilder->buildSetGimbalControlAngleRequestMessage(frame, static_cast<int16_t>(pan * 10), static_cast<int16_t>(tilt * 10));
+    return sendFrame(frame);
+}
+
+bool RealtimeSender::setRates(float panRate, float tiltRate) {
+    FrameBuffer frame;
+    _messageBuilder->buildGimbalRotationRequestMessage(frame, static_cast<int8_t>(panRate), static_cast<int8_t>(tiltRate));
+    return sendFrame(frame);
+}
+
+bool RealtimeSender::send(Command command, const uint8_t* data, size_t dataLength) {
+    FrameBuffer frame;
+    if (!_messageBuilder->encode(frame, command, data, dataLength)) {
+        return false;
+    }
+    return sendFrame(frame);
+}
+
+bool RealtimeSender::sendFrame(const FrameBuffer& frame) {
+#ifdef Q_OS_UNIX
+    if (!valid()) {
+        return false;
+    }
+    sockaddr_in address{};
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(_ipv4Address);
+    address.sin_port        = htons(_port);
+
+    const auto sent = ::sendto(static_cast<int>(_descriptor), frame.data(), frame.size(), MSG_DONTWAIT,
+                               reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    if (sent != static_cast<ssize_t>(frame.size())) {
+        _metrics->directSendFailed();
+        return false;
+    }
+    _metrics->directFrameSent(frame.size());
+    return true;
+#else
+    Q_UNUSED(frame)
+    return false;
+#endif
+}
+
+} // namespace siyi
@@ -0,0 +1,152 @@
+#include "RequestTracker.h"
+
+#include <algorithm>
+
+#include "MessageBuilder.h"
+
+namespace siyi {
+
+namespace {
+/**
+ * @param request Decoded PHOTO_VIDEO_HDR request
+ * @return Bit mask of the FunctionFeedbackMessage states reporting the requested function
+ */
+uint8_t feedbackStates(const FrameView& request) {
+    if (request.command != Command::PHOTO_VIDEO_HDR || request.dataLength < 1) {
+        return 0xFF;
+    }
+    switch (request.data[0]) {
+    case 0: // Take photo: success, photo failed
+        return (1u << 0) | (1u << 1);
+    case 1: // HDR: on, off
+        return (1u << 2) | (1u << 3);
+    case 2: // Recording: success, recording failed
+        return (1u << 0) | (1u << 4);
+    default:
+        return 0xFF;
+    }
+}
+} // namespace
+
+RequestTracker::~RequestTracker() {
+    cancelAll();
+}
+
+void RequestTracker::add(const QByteArray& message, Command responseCommand, const RequestOptions& options, RequestCallback callback,
+                         Clock::time_point now) {
+    const auto request = MessageBuilder::decode(message);
+
+    Pending pending;
+    pending.message         = message;
+    pending.responseCommand = responseCommand;
+    pending.sequenceNumber  = request.sequenceNumber;
+    pending.feedbackStates  = responseCommand == Command::FUNC_FEEDBACK_INFO ? feedbackStates(request) : uint8_t{0xFF};
+    pending.timeout         = options.timeout;
+    pending.retriesLeft     = std::max(options.retries, 0);
+    pending.sentAt          = now;
+    pending.deadline        = now + options.timeout;
+    pending.callback        = std::move(callback);
+    _pending.push_back(std::move(pending));
+}
+
+bool RequestTracker::complete(const FrameView& frame, Clock::time_point now) {
+    auto match = _pending.end();
+    for (auto it = _pending.begin(); it != _pending.end(); ++it) {
+        if (!answers(*it, frame)) {
+            continue;
+        }
+        if (it->sequenceNumber == frame.sequenceNumber) {
+            match = it;
+            break;
+        }
+        if (_sequenceFallback && match == _pending.end()) {
+            match = it;
+        }
+    }
+    if (match == _pending.end()) {
+        return false;
+    }
+
+    auto pending = std::move(*match);
+    _pending.erase(match);
+
+    RequestResult result;
+    result.status        = RequestStatus::Acknowledged;
+    result.command       = frame.command;
+    result.payload       = QByteArray(reinterpret_cast<const char*>(frame.data), static_cast<int>(frame.dataLength));
+    // The acknowledge may have arrived in the kernel before a retransmission went out
+    result.roundTripTime = std::max<std::chrono::nanoseconds>(now - pending.sentAt, std::chrono::nanoseconds(0));
+    finish(pending, result);
+    return true;
+}
+
+void RequestTracker::expire(Clock::time_point now, const SendFunction& send) {
+    std::vector<Pending> timedOut;
+    for (auto it = _pending.begin(); it != _pending.end();) {
+        if (it->deadline > now) {
+            ++it;
+            continue;
+        }
+        if (it->retriesLeft > 0) {
+            --it->retriesLeft;
+            ++it->attempts;
+            it->sentAt   = now;
+            it->deadline = now + it->timeout;
+            send(it->message);
+            ++it;
+            continue;
+        }
+        timedOut.push_back(std::move(*it));
+        it = _pending.erase(it);
+    }
+
+    // Callbacks run last, they may add new requests
+    for (auto& pending : timedOut) {
+        RequestResult result;
+        result.status  = RequestStatus::TimedOut;
+        result.command = pending.responseCommand;
+        finish(pending, result);
+    }
+}
+
+void RequestTracker::cancelAll() {
+    auto cancelled = std::move(_pending);
+    _pending.clear();
+    for (auto& pending : cancelled) {
+        RequestResult result;
+        result.status  = RequestStatus::Cancelled;
+        result.command = pending.responseCommand;
+        finish(pending, result);
+    }
+}
+
+std::optional<RequestTracker::Clock::time_point> RequestTracker::nextDeadline() const {
+    if (_pending.empty()) {
+        return std::nullopt;
+    }
+    auto earliest = std::min_element(_pending.begin(), _pending.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.deadline < rhs.deadline;
+    });
+    return earliest->deadline;
+}
+
+bool RequestTracker::answers(const Pending& pending, const FrameView& frame) {
+    if (pending.responseCommand != frame.command) {
+        return false;
+    }
+    if (frame.command != Command::FUNC_FEEDBACK_INFO || pending.feedbackStates == 0xFF) {
+        return true;
+    }
+    // An HDR or recording feedback must not complete a photo request
+    return frame.dataLength >= 1 && frame.data[0] < 8 && (pending.feedbackStates & (1u << frame.data[0])) != 0;
+}
+
+void RequestTracker::finish(Pending& pending, RequestResult& result) {
+    result.sequenceNumber = pending.sequenceNumber;
+    result.attempts       = pending.attempts;
+    if (pending.callback) {
+        pending.callback(result);
+    }
+}
+
+} // namespace siyi
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include <QByteArray>
+
+#include "Frame.h"
+#include "Request.h"
+
+namespace siyi {
+
+/**
+ * Pending requests of one camera, correlated with acknowledges by command and sequence number.
+ * An acknowledge completes the request with its sequence number. Firmware that does not echo sequence
+ * numbers needs setSequenceFallback(), then an acknowledge without a match completes the oldest request
+ * waiting for the same command. A function feedback only completes a request for the function it reports.
+ * Not thread safe, used on the communication thread only.
+ */
+class RequestTracker {
+public:
+    using Clock        = std::chrono::steady_clock;
+    using SendFunction = std::function<void(const QByteArray& message)>;
+
+    RequestTracker() = default;
+    ~RequestTracker();
+
+    RequestTracker(const RequestTracker&)            = delete;
+    RequestTracker& operator=(const RequestTracker&) = delete;
+
+    /**
+     * Track request that was just sent
+     * @param message Encoded request, kept for retransmission
+     * @param responseCommand Command of the expected acknowledge
+     * @param options Deadline and retries
+     * @param callback Completion callback
+     * @param now Send time
+     */
+    void add(const QByteArray& message, Command responseCommand, const RequestOptions& options, RequestCallback callback,
+             Clock::time_point now);
+
+    /**
+     * Complete request acknowledged by frame
+     * @param frame Received frame
+     * @param now Receive time
+     * @return True if frame acknowledged a pending request
+     */
+    bool complete(const FrameView& frame, Clock::time_point now);
+
+    /**
+     * Complete the oldest request for the same command when no sequence number matches
+     * @param enabled True for firmware that does not echo request sequence numbers
+     */
+    void setSequenceFallback(bool enabled) { _sequenceFallback = enabled; }
+
+    /**
+     * Retransmit requests past their deadline, or time them out when no retries are left
+     * @param now Current time
+     * @param send Retransmits message
+     */
+    void expire(Clock::time_point now, const SendFunction& send);
+
+    /**
+     * Complete all pending requests with RequestStatus::Cancelled
+     */
+    void cancelAll();
+
+    /**
+     * @return Earliest deadline, empty if nothing is pending
+     */
+    [[nodiscard]] std::optional<Clock::time_point> nextDeadline() const;
+
+    [[nodiscard]] bool empty() const { return _pending.empty(); }
+
+private:
+    struct Pending {
+        QByteArray                message;
+        Command                   responseCommand{Command::UNKNOWN};
+        uint16_t                  sequenceNumber{0};
+        uint8_t                   feedbackStates{0xFF}; // FunctionFeedbackMessage states that answer the request, one bit each
+        std::chrono::milliseconds timeout{0};
+        int                       retriesLeft{0};
+        int                       attempts{1};
+        Clock::time_point         sentAt;
+        Clock::time_point         deadline;
+        RequestCallback           callback;
+    };
+
+    /**
+     * @return True if frame answers pending request
+     */
+    static bool answers(const Pending& pending, const FrameView& frame);
+
+    /**
+     * Invoke callback of finished request
+     */
+    static void finish(Pending& pending, RequestResult& result);
+
+private:
+    std::vector<Pending> _pending; // Oldest first
+    bool                 _sequenceFallback{false};
+};
+
+} // namespace siyi
@@ -0,0 +1,179 @@
+#include "SerialTransport.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(siyiSdkSerial, "siyi.sdk.serial")
+
+namespace siyi {
+
+namespace {
+constexpr size_t kMaxUnsentBytes{4096}; // About 0.35 s at 115200 baud, newer frames are rejected beyond it
+
+/**
+ * @return termios speed constant, B0 if the baud rate is not supported
+ */
+speed_t toSpeed(int baudRate) {
+    switch (baudRate) {
+    case 9600:
+        return B9600;
+    case 19200:
+        return B19200;
+    case 38400:
+        return B38400;
+    case 57600:
+        return B57600;
+    case 115200:
+        return B115200;
+    case 230400:
+        return B230400;
+#ifdef B460800
+    case 460800:
+        return B460800;
+#endif
+#ifdef B921600
+    case 921600:
+        return B921600;
+#endif
+    default:
+        return B0;
+    }
+}
+} // namespace
+
+SerialTransport::SerialTransport(const QString& device, int baudRate)
+    : _device(device)
+    , _baudRate(baudRate) {}
+
+SerialTransport::~SerialTransport() {
+    _readNotifier.reset();
+    _writeNotifier.reset();
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+bool SerialTransport::open(ReceiveHandler handler) {
+    _handler = std::move(handler);
+    _fd      = ::open(_device.toLocal8Bit().constData(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (_fd < 0) {
+        qCWarning(siyiSdkSerial) << "Failed to open" << _device << std::strerror(errno);
+        return false;
+    }
+    if (!configure()) {
+        qCWarning(siyiSdkSerial) << "Failed to configure" << _device << "at" << _baudRate << "baud";
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    _readNotifier = std::make_unique<QSocketNotifier>(_fd, QSocketNotifier::Read);
+    QObject::connect(_readNotifier.get(), &QSocketNotifier::activated, _readNotifier.get(), [this] { readAvailable(); });
+
+    _unsent.reserve(kMaxUnsentBytes);
+    _writeNotifier = std::make_unique<QSocketNotifier>(_fd, QSocketNotifier::Write);
+    _writeNotifier->setEnabled(false);
+    QObject::connect(_writeNotifier.get(), &QSocketNotifier::activated, _writeNotifier.get(), [this] { writeUnsent(); });
+    return true;
+}
+
+bool SerialTransport::send(const uint8_t* data, size_t length, uint32_t /*ipv4Address*/, uint16_t /*port*/) {
+    if (_fd < 0) {
+        return false;
+    }
+    // Keep frame order, newer frames wait behind the unsent tail
+    if (!_unsent.empty()) {
+        if (_unsent.size() + length > kMaxUnsentBytes) {
+            return false;
+        }
+        _unsent.insert(_unsent.end(), data, data + length);
+        return true;
+    }
+
+    auto written = ::write(_fd, data, length);
+    if (written < 0) {
+        if (errno != EAGAIN && errno != EINTR) {
+            return false;
+        }
+        written = 0;
+    }
+    if (written < static_cast<ssize_t>(length)) {
+        // The line is congested, the rest of the frame goes out once the tty accepts it
+        _unsent.insert(_unsent.end(), data + written, data + length);
+        _writeNotifier->setEnabled(true);
+    }
+    return true;
+}
+
+bool SerialTransport::configure() {
+    const auto speed = toSpeed(_baudRate);
+    if (speed == B0) {
+        return false;
+    }
+    termios options{};
+    if (::tcgetattr(_fd, &options) != 0) {
+        return false;
+    }
+    ::cfmakeraw(&options);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    options.c_cc[VMIN]  = 0;
+    options.c_cc[VTIME] = 0;
+    if (::cfsetispeed(&options, speed) != 0 || ::cfsetospeed(&options, speed) != 0) {
+        return false;
+    }
+    if (::tcsetattr(_fd, TCSANOW, &options) != 0) {
+        return false;
+    }
+    ::tcflush(_fd, TCIOFLUSH);
+    return true;
+}
+
+void SerialTransport::writeUnsent() {
+    while (!_unsent.empty()) {
+        const auto written = ::write(_fd, _unsent.data(), _unsent.size());
+        if (written > 0) {
+            _unsent.erase(_unsent.begin(), _unsent.begin() + written);
+            continue;
+        }
+        if (written == 0 || errno == EAGAIN || errno == EINTR) {
+            return;
+        }
+        qCWarning(siyiSdkSerial) << "Failed to write" << _unsent.size() << "bytes to" << _device << std::strerror(errno);
+        _unsent.clear();
+        break;
+    }
+    _writeNotifier->setEnabled(false);
+}
+
+bool SerialTransport::hungUp() const {
+    pollfd descriptor{_fd, POLLIN, 0};
+    return ::poll(&descriptor, 1, 0) > 0 && (descriptor.revents & (POLLHUP | POLLERR)) != 0;
+}
+
+void SerialTransport::readAvailable() {
+    for (bool received = false;; received = true) {
+        const auto count = ::read(_fd, _chunk.data(), _chunk.size());
+        if (count > 0) {
+            _handler(_chunk.data(), static_cast<size_t>(count), 0, 0, Clock::now());
+            continue;
+        }
+        // With VMIN and VTIME at 0 an empty tty reads 0 bytes. Only a readable notification without any byte can be a hangup.
+        if ((count == 0 && (received || !hungUp())) || (count < 0 && (errno == EAGAIN || errno == EINTR))) {
+            return;
+        }
+        // Device unplugged (EIO) or pseudo-terminal peer closed, stop polling a descriptor that stays readable
+        qCWarning(siyiSdkSerial) << "Serial link closed" << _device;
+        _readNotifier->setEnabled(false);
+        return;
+    }
+}
+
+} // namespace siyi
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <QSocketNotifier>
+#include <QString>
+
+#include "Transport.h"
+
+namespace siyi {
+
+/**
+ * Raw termios UART link to one camera: 8N1, no flow control, non-blocking.
+ * A frame the tty accepts only partly is finished before any newer frame, so the camera never sees half a frame.
+ * Works with any tty including pseudo-terminals, e.g. one end of `socat pty,raw pty,raw`.
+ */
+class SerialTransport : public Transport {
+public:
+    SerialTransport(const QString& device, int baudRate);
+    ~SerialTransport() override;
+
+    bool open(ReceiveHandler handler) override;
+    bool send(const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port) override;
+
+    [[nodiscard]] bool ready() const override { return _fd >= 0; }
+    [[nodiscard]] bool streamOriented() const override { return true; }
+
+private:
+    /**
+     * Put descriptor into raw mode
+     * @return False if the baud rate is not supported or the device is not a tty
+     */
+    bool configure();
+
+    void readAvailable();
+
+    /**
+     * @return True if the device reports a hangup
+     */
+    [[nodiscard]] bool hungUp() const;
+
+    /**
+     * Write bytes left over by short writes, stops the write notifier once all are sent
+     */
+    void writeUnsent();
+
+private:
+    QString                          _device;
+    int                              _baudRate;
+    int                              _fd{-1};
+    ReceiveHandler                   _handler;
+    std::unique_ptr<QSocketNotifier> _readNotifier;
+    std::unique_ptr<QSocketNotifier> _writeNotifier; // Enabled while bytes are unsent
+    std::array<uint8_t, 4096>        _chunk{};       // Reused receive buffer
+    std::vector<uint8_t>             _unsent;        // Tail of a short write and frames queued behind it
+};
+
+} // namespace siyi
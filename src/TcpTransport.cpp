@@ -0,0 +1,81 @@
+#include "TcpTransport.h"
+
+#include <QHostAddress>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(siyiSdkTcp, "siyi.sdk.tcp")
+
+namespace siyi {
+
+namespace {
+constexpr auto kReconnectInterval{1000}; // Reconnect interval in ms
+constexpr auto kReceiveChunkSize{4096};
+} // namespace
+
+TcpTransport::TcpTransport(const QString& host, quint16 port)
+    : _host(host)
+    , _port(port) {}
+
+TcpTransport::~TcpTransport() = default;
+
+bool TcpTransport::open(ReceiveHandler handler) {
+    _handler = std::move(handler);
+    _chunk.resize(kReceiveChunkSize);
+
+    _socket = std::make_unique<QTcpSocket>();
+    QObject::connect(_socket.get(), &QTcpSocket::readyRead, _socket.get(), [this] { readAvailable(); });
+    QObject::connect(_socket.get(), &QTcpSocket::connected, _socket.get(), [this] {
+        // Frames are tiny, do not let Nagle hold them back
+        _socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        _socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+        qCInfo(siyiSdkTcp) << "Connected to" << _host << _port;
+        notifyReady();
+    });
+    QObject::connect(_socket.get(), &QTcpSocket::disconnected, _socket.get(), [this] {
+        qCWarning(siyiSdkTcp) << "Connection lost, reconnecting";
+        _reconnectTimer->start();
+    });
+    QObject::connect(_socket.get(), &QTcpSocket::errorOccurred, _socket.get(), [this](QAbstractSocket::SocketError) {
+        if (_socket->state() != QAbstractSocket::ConnectedState && !_reconnectTimer->isActive()) {
+            _reconnectTimer->start();
+        }
+    });
+
+    _reconnectTimer = std::make_unique<QTimer>();
+    _reconnectTimer->setSingleShot(true);
+    _reconnectTimer->setInterval(kReconnectInterval);
+    QObject::connect(_reconnectTimer.get(), &QTimer::timeout, _reconnectTimer.get(), [this] { connectToCamera(); });
+
+    connectToCamera();
+    return true;
+}
+
+bool TcpTransport::send(const uint8_t* data, size_t length, uint32_t /*ipv4Address*/, uint16_t /*port*/) {
+    if (!_socket || _socket->state() != QAbstractSocket::ConnectedState) {
+        return false;
+    }
+    return _socket->write(reinterpret_cast<const char*>(data), static_cast<qint64>(length)) == static_cast<qint64>(length);
+}
+
+bool TcpTransport::ready() const {
+    return _socket && _socket->state() == QAbstractSocket::ConnectedState;
+}
+
+void TcpTransport::connectToCamera() {
+    _socket->abort();
+    _socket->connectToHost(_host, _port);
+}
+
+void TcpTransport::readAvailable() {
+    const auto peer     = _socket->peerAddress().toIPv4Address();
+    const auto peerPort = _socket->peerPort();
+    while (_socket->bytesAvailable() > 0) {
+        const auto count = _socket->read(_chunk.data(), _chunk.size());
+        if (count <= 0) {
+            break;
+        }
+        _handler(reinterpret_cast<const uint8_t*>(_chunk.constData()), static_cast<size_t>(count), peer, peerPort, Clock::now());
+    }
+}
+
+} // namespace siyi
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+
+#include <QByteArray>
+#include <QString>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "Transport.h"
+
+namespace siyi {
+
+/**
+ * Persistent TCP connection to one camera, reconnects after the link drops
+ */
+class TcpTransport : public Transport {
+public:
+    TcpTransport(const QString& host, quint16 port);
+    ~TcpTransport() override;
+
+    bool open(ReceiveHandler handler) override;
+    bool send(const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port) override;
+
+    [[nodiscard]] bool ready() const override;
+    [[nodiscard]] bool streamOriented() const override { return true; }
+
+private:
+    void connectToCamera();
+    void readAvailable();
+
+private:
+    QString                     _host;
+    quint16                     _port;
+    ReceiveHandler              _handler;
+    std::unique_ptr<QTcpSocket> _socket;
+    std::unique_ptr<QTimer>     _reconnectTimer;
+    QByteArray                  _chunk; // Reused receive buffer
+};
+
+} // namespace siyi
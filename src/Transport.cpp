@@ -0,0 +1,30 @@
+#include "Transport.h"
+
+#include <QtGlobal>
+
+#include "TcpTransport.h"
+#include "UdpTransport.h"
+
+#ifdef SIYI_SERIAL_TRANSPORT
+#include "SerialTransport.h"
+#endif
+
+namespace siyi {
+
+std::unique_ptr<Transport> Transport::create(const TransportConfig& config) {
+    switch (config.type) {
+    case TransportConfig::Type::Udp:
+        return std::make_unique<UdpTransport>(config.localPort);
+    case TransportConfig::Type::Tcp:
+        return std::make_unique<TcpTransport>(config.host, config.port);
+    case TransportConfig::Type::Serial:
+#ifdef SIYI_SERIAL_TRANSPORT
+        return std::make_unique<SerialTransport>(config.device, config.baudRate);
+#else
+        return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+} // namespace siyi
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "TransportConfig.h"
+
+namespace siyi {
+
+/**
+ * Byte transport below the shared framing and dispatch pipeline of CommunicationWorker.
+ * Datagram transports deliver one frame per call, stream transports deliver arbitrary chunks that
+ * go through StreamFramer. All methods are called on the communication thread.
+ */
+class Transport {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Called for received bytes with the sender address in host byte order, the data is only valid during the call.
+     * The receive time is the kernel timestamp of the datagram where the backend provides one, otherwise the
+     * monotonic time at which the bytes were read.
+     */
+    using ReceiveHandler =
+        std::function<void(const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port, Clock::time_point receiveTime)>;
+
+    /**
+     * Called when a link that connects in the background becomes able to send
+     */
+    using ReadyHandler = std::function<void()>;
+
+    virtual ~Transport() = default;
+
+    /**
+     * Create backend for configuration
+     * @param config Transport configuration
+     * @return Backend, nullptr if the type is not available on this platform
+     */
+    static std::unique_ptr<Transport> create(const TransportConfig& config);
+
+    /**
+     * Open link and start receiving
+     * @param handler Receive handler
+     * @return False if the link could not be opened, persistent links keep retrying in the background
+     */
+    virtual bool open(ReceiveHandler handler) = 0;
+
+    /**
+     * Set handler for links that become ready after open() returned, call before open()
+     * @param handler Ready handler
+     */
+    void setReadyHandler(ReadyHandler handler) { _readyHandler = std::move(handler); }
+
+    /**
+     * @return True if send() can deliver frames: the socket is bound, the connection is established or the device is open
+     */
+    [[nodiscard]] virtual bool ready() const = 0;
+
+    /**
+     * Send one frame
+     * @param data Encoded frame
+     * @param length Frame length
+     * @param ipv4Address Destination in host byte order, ignored by point-to-point links
+     * @param port Destination port, ignored by point-to-point links
+     * @return False if the frame was not sent
+     */
+    virtual bool send(const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port) = 0;
+
+    /**
+     * Send frames that send() queued for a later batch right away, e.g. before stamping their send time
+     */
+    virtual void flush() {}
+
+    /**
+     * @return True if received chunks may hold partial or several frames
+     */
+    [[nodiscard]] virtual bool streamOriented() const = 0;
+
+    /**
+     * @return Datagram socket usable with sendto() from other threads, -1 if there is none
+     */
+    [[nodiscard]] virtual intptr_t descriptor() const { return -1; }
+
+protected:
+    /**
+     * Report that the link became ready
+     */
+    void notifyReady() {
+        if (_readyHandler) {
+            _readyHandler();
+        }
+    }
+
+private:
+    ReadyHandler _readyHandler;
+};
+
+} // namespace siyi
@@ -0,0 +1,119 @@
+#include "UdpTransport.h"
+
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(siyiSdkUdp, "siyi.sdk.udp")
+
+namespace siyi {
+
+UdpTransport::UdpTransport(quint16 localPort)
+    : _localPort(localPort) {}
+
+UdpTransport::~UdpTransport() = default;
+
+bool UdpTransport::open(ReceiveHandler handler) {
+    _handler = std::move(handler);
+#ifdef SIYI_BATCHED_SOCKET
+    if (openBatchedSocket()) {
+        return true;
+    }
+    qCWarning(siyiSdkUdp) << "Batched socket unavailable, falling back to QUdpSocket";
+#endif
+    _socket = std::make_unique<QUdpSocket>();
+    if (!_socket->bind(QHostAddress::Any, _localPort)) {
+        qCWarning(siyiSdkUdp) << "Failed to bind to port";
+        return false;
+    }
+    QObject::connect(_socket.get(), &QUdpSocket::readyRead, _socket.get(), [this] { readPendingDatagrams(); });
+    return _socket->state() == QUdpSocket::SocketState::BoundState;
+}
+
+bool UdpTransport::send(const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port) {
+#ifdef SIYI_BATCHED_SOCKET
+    if (_batchedSocket) {
+        if (!_batchedSocket->queue(data, length, ipv4Address, port)) {
+            return false;
+        }
+        if (!_flushTimer->isActive()) {
+            _flushTimer->start();
+        }
+        return true;
+    }
+#endif
+    if (!_socket) {
+        return false;
+    }
+    // QHostAddress allocates, keep the last destination
+    if (ipv4Address != _destinationIpv4) {
+        _destinationIpv4    = ipv4Address;
+        _destinationAddress = QHostAddress(ipv4Address);
+    }
+    return _socket->writeDatagram(reinterpret_cast<const char*>(data), static_cast<qint64>(length), _destinationAddress, port) != -1;
+}
+
+void UdpTransport::flush() {
+#ifdef SIYI_BATCHED_SOCKET
+    if (_batchedSocket) {
+        _batchedSocket->flush();
+        _flushTimer->stop();
+    }
+#endif
+}
+
+bool UdpTransport::ready() const {
+#ifdef SIYI_BATCHED_SOCKET
+    if (_batchedSocket) {
+        return true;
+    }
+#endif
+    return _socket && _socket->state() == QUdpSocket::SocketState::BoundState;
+}
+
+intptr_t UdpTransport::descriptor() const {
+#ifdef SIYI_BATCHED_SOCKET
+    if (_batchedSocket) {
+        return _batchedSocket->descriptor();
+    }
+#endif
+    return _socket ? static_cast<intptr_t>(_socket->socketDescriptor()) : -1;
+}
+
+void UdpTransport::readPendingDatagrams() {
+    QHostAddress sender;
+    quint16      senderPort = 0;
+    while (_socket->hasPendingDatagrams()) {
+        // Receive buffer is reused, it only reallocates when a larger datagram arrives
+        _datagram.resize(static_cast<int>(_socket->pendingDatagramSize()));
+        _socket->readDatagram(_datagram.data(), _datagram.size(), &sender, &senderPort);
+        // QUdpSocket does not expose kernel timestamps
+        _handler(reinterpret_cast<const uint8_t*>(_datagram.constData()),
+                 static_cast<size_t>(_datagram.size()),
+                 sender.toIPv4Address(),
+                 senderPort,
+                 Clock::now());
+    }
+}
+
+#ifdef SIYI_BATCHED_SOCKET
+bool UdpTransport::openBatchedSocket() {
+    auto socket = std::make_unique<BatchedUdpSocket>();
+    if (!socket->bind(_localPort)) {
+        return false;
+    }
+    _batchedSocket = std::move(socket);
+
+    _readNotifier = std::make_unique<QSocketNotifier>(_batchedSocket->descriptor(), QSocketNotifier::Read);
+    QObject::connect(_readNotifier.get(), &QSocketNotifier::activated, _readNotifier.get(), [this] {
+        _batchedSocket->receive(_handler);
+    });
+
+    // Frames queued during one event loop pass go out with a single sendmmsg
+    _flushTimer = std::make_unique<QTimer>();
+    _flushTimer->setSingleShot(true);
+    _flushTimer->setInterval(0);
+    QObject::connect(_flushTimer.get(), &QTimer::timeout, _flushTimer.get(), [this] { _batchedSocket->flush(); });
+    return true;
+}
+#endif
+
+} // namespace siyi
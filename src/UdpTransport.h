@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+
+#include <QByteArray>
+#include <QUdpSocket>
+
+#ifdef SIYI_BATCHED_SOCKET
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include "BatchedUdpSocket.h"
+#endif
+
+#include "Transport.h"
+
+namespace siyi {
+
+/**
+ * UDP socket shared by all cameras. Uses BatchedUdpSocket when built with SIYI_BATCHED_SOCKET
+ * and falls back to QUdpSocket if it cannot be bound.
+ */
+class UdpTransport : public Transport {
+public:
+    explicit UdpTransport(quint16 localPort);
+    ~UdpTransport() override;
+
+    bool open(ReceiveHandler handler) override;
+    bool send(const uint8_t* data, size_t length, uint32_t ipv4Address, uint16_t port) override;
+    void flush() override;
+
+    [[nodiscard]] bool     ready() const override;
+    [[nodiscard]] bool     streamOriented() const override { return false; }
+    [[nodiscard]] intptr_t descriptor() const override;
+
+private:
+    void readPendingDatagrams();
+
+#ifdef SIYI_BATCHED_SOCKET
+    /**
+     * Open recvmmsg/sendmmsg socket
+     * @return False if the socket could not be bound
+     */
+    bool openBatchedSocket();
+#endif
+
+private:
+    quint16                     _localPort;
+    ReceiveHandler              _handler;
+    std::unique_ptr<QUdpSocket> _socket;
+    QByteArray                  _datagram; // Reused receive buffer
+    uint32_t                    _destinationIpv4{0};
+    QHostAddress                _destinationAddress;
+
+#ifdef SIYI_BATCHED_SOCKET
+    std::unique_ptr<BatchedUdpSocket> _batchedSocket;
+    std::unique_ptr<QSocketNotifier>  _readNotifier;
+    std::unique_ptr<QTimer>           _flushTimer;
+#endif
+};
+
+} // namespace siyi